@@ -0,0 +1,68 @@
+#ifndef BITMAP_H
+#define BITMAP_H
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+inline unsigned lowestSetBit(uint64_t w) {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned>(__builtin_ctzll(w));
+#else
+  unsigned n = 0;
+  while (!(w & 1)) { w >>= 1; n++; }
+  return n;
+#endif
+}
+
+// Fixed-size bitset over row (or cell) indices, 64 per word.  Set bits are
+// visited in ascending order by skipping zero words and counting trailing
+// zeros, so sparse flags over large tables cost one load per 64 rows.
+class RowBitmap {
+public:
+  RowBitmap() = default;
+  explicit RowBitmap(size_t bits) : bits_(bits), words_((bits + 63) / 64, 0) {}
+
+  size_t size() const { return bits_; }
+  // `bits` clear bits, reusing the existing storage
+  void assign(size_t bits) {
+    bits_ = bits;
+    words_.assign((bits + 63) / 64, 0);
+  }
+  void push_back(bool bit) {
+    if (bits_ % 64 == 0) words_.push_back(0);
+    if (bit) set(bits_);
+    bits_++;
+  }
+  void set(size_t i) { words_[i >> 6] |= uint64_t(1) << (i & 63); }
+  void reset(size_t i) { words_[i >> 6] &= ~(uint64_t(1) << (i & 63)); }
+  bool test(size_t i) const { return (words_[i >> 6] >> (i & 63)) & 1u; }
+
+  size_t count() const {
+    size_t n = 0;
+    for (uint64_t w : words_) n += std::bitset<64>(w).count();
+    return n;
+  }
+
+  template <typename Fn>
+  void forEachSet(Fn&& fn) const {
+    for (size_t wi = 0; wi < words_.size(); wi++) {
+      for (uint64_t w = words_[wi]; w; w &= w - 1)
+        fn(wi * 64 + lowestSetBit(w));
+    }
+  }
+
+  RowBitmap& operator|=(const RowBitmap& other) {
+    for (size_t i = 0; i < words_.size() && i < other.words_.size(); i++) words_[i] |= other.words_[i];
+    return *this;
+  }
+
+  const std::vector<uint64_t>& words() const { return words_; }
+
+private:
+  size_t bits_ = 0;
+  std::vector<uint64_t> words_;
+};
+
+#endif
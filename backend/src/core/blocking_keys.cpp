@@ -0,0 +1,175 @@
+#include "blocking_keys.h"
+#include "char_class.h"
+#include <algorithm>
+
+// --- ASCII folding -------------------------------------------------------
+
+// Base letters for U+00C0..U+00FF; 0 where there is none (× ÷).
+static const char LATIN1_FOLD[65] =
+  "aaaaaaaceeeeiiii" "dnooooo\0ouuuuyts"
+  "aaaaaaaceeeeiiii" "dnooooo\0ouuuuyty";
+
+std::string asciiFold(std::string_view s) {
+  std::string out;
+  out.reserve(s.size());
+  for (size_t i = 0; i < s.size(); i++) {
+    unsigned char c = static_cast<unsigned char>(s[i]);
+    if (c == 0xC3 && i + 1 < s.size()) {
+      unsigned char next = static_cast<unsigned char>(s[i + 1]);
+      if (next >= 0x80 && next <= 0xBF) {
+        char base = LATIN1_FOLD[next - 0x80];
+        i++;
+        if (base) out += base;
+        continue;
+      }
+    }
+    out += lowerChar(static_cast<char>(c));
+  }
+  return out;
+}
+
+// --- Soundex --------------------------------------------------------------
+
+// Digit per letter a-z; 0 for vowels and y (which separate equal codes),
+// 7 for h and w (which do not).
+static const char SOUNDEX_DIGIT[27] = "01230127022455012623017202";
+
+uint16_t soundexCode(std::string_view word) {
+  uint16_t code = 0;
+  int digits = 0;
+  char last = 0;
+  for (char c : word) {
+    char l = lowerChar(c);
+    if (l < 'a' || l > 'z') continue;
+    char d = SOUNDEX_DIGIT[l - 'a'];
+    if (code == 0) {
+      code = static_cast<uint16_t>((l - 'a' + 1) << 9);
+      last = d;
+      continue;
+    }
+    if (d == '7') continue;  // h, w: keep `last` so the codes either side merge
+    if (d != '0' && d != last) {
+      code |= static_cast<uint16_t>((d - '0') << (6 - 3 * digits));
+      if (++digits == 3) break;
+    }
+    last = d;
+  }
+  return code;
+}
+
+// --- prefixes ----------------------------------------------------------------
+
+// 6-bit code per character in byte order: 0 pad, digits, letters, then
+// the few punctuation marks that appear in identifiers and local parts.
+static uint64_t charCode(char c) {
+  if (c >= '0' && c <= '9') return 1 + (c - '0');
+  if (c >= 'a' && c <= 'z') return 11 + (c - 'a');
+  switch (c) {
+    case '-': return 37;
+    case '.': return 38;
+    case '_': return 39;
+    default:  return 40;
+  }
+}
+
+uint64_t packPrefix(std::string_view folded, int chars) {
+  chars = std::min(chars, 10);
+  uint64_t key = 0;
+  int taken = 0;
+  for (size_t i = 0; i < folded.size() && taken < chars; i++) {
+    char c = folded[i];
+    if (charClass(c) & CC_CSPACE) continue;
+    key = (key << 6) | charCode(c);
+    taken++;
+  }
+  return key << (6 * (chars - taken));
+}
+
+std::string_view emailLocalPart(std::string_view email) {
+  size_t at = email.find('@');
+  std::string_view local = email.substr(0, at);
+  size_t plus = local.find('+');
+  if (plus != std::string_view::npos) local = local.substr(0, plus);
+  return local;
+}
+
+std::string_view urlHost(std::string_view url) {
+  size_t scheme = url.find("://");
+  if (scheme != std::string_view::npos) url.remove_prefix(scheme + 3);
+  size_t end = url.find_first_of("/?#:");
+  if (end != std::string_view::npos) url = url.substr(0, end);
+  if (url.size() > 4 && url.substr(0, 4) == "www.") url.remove_prefix(4);
+  return url;
+}
+
+uint64_t packTrailingDigits(std::string_view text, int digits) {
+  digits = std::min(digits, 16);
+  uint64_t key = 0;
+  int taken = 0;
+  for (size_t i = text.size(); i-- > 0 && taken < digits;) {
+    if (text[i] < '0' || text[i] > '9') continue;
+    key |= static_cast<uint64_t>(text[i] - '0' + 1) << (4 * taken);
+    taken++;
+  }
+  return key;
+}
+
+// --- row keys --------------------------------------------------------------
+
+// Alphabetically first alphanumeric token of folded text.
+static std::string_view firstToken(std::string_view folded) {
+  std::string_view best;
+  size_t i = 0;
+  while (i < folded.size()) {
+    while (i < folded.size() && !(charClass(folded[i]) & (CC_ALPHA | CC_DIGIT))) i++;
+    size_t start = i;
+    while (i < folded.size() && (charClass(folded[i]) & (CC_ALPHA | CC_DIGIT))) i++;
+    if (i > start) {
+      std::string_view tok = folded.substr(start, i - start);
+      if (best.empty() || tok < best) best = tok;
+    }
+  }
+  return best;
+}
+
+uint64_t rowBlockingKey(const std::vector<std::string>& row,
+                        const std::vector<ColumnType>& columnTypes) {
+  uint64_t key = 0;
+  int bitsLeft = 64;
+  auto put = [&](uint64_t field, int width) {
+    if (width > bitsLeft) {
+      field >>= (width - bitsLeft);  // keep the most significant part
+      width = bitsLeft;
+    }
+    key = (key << width) | field;
+    bitsLeft -= width;
+  };
+
+  size_t n = std::min(row.size(), columnTypes.size());
+  for (size_t i = 0; i < n && bitsLeft > 0; i++) {
+    switch (columnTypes[i]) {
+      case ColumnType::ID:
+      case ColumnType::NUMERIC:
+      case ColumnType::BOOLEAN:
+      case ColumnType::DATE:
+        continue;
+      case ColumnType::NAME:
+        put(soundexCode(firstToken(asciiFold(row[i]))), 16);
+        break;
+      case ColumnType::EMAIL:
+        put(packPrefix(asciiFold(emailLocalPart(row[i])), 5), 30);
+        break;
+      case ColumnType::URL:
+        put(packPrefix(urlHost(asciiFold(row[i])), 5), 30);
+        break;
+      case ColumnType::PHONE:
+        put(packTrailingDigits(row[i], 8), 32);
+        break;
+      default:
+        put(packPrefix(asciiFold(row[i]), 4), 24);
+        break;
+    }
+  }
+  // no keyed column leaves all 64 bits free, and shifting by 64 is undefined
+  return bitsLeft == 64 ? 0 : key << bitsLeft;
+}
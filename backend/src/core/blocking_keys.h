@@ -0,0 +1,50 @@
+#ifndef BLOCKING_KEYS_H
+#define BLOCKING_KEYS_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "column_type_detection.h"
+
+// Compact keys for blocking near-duplicate rows.  Each row's key is computed
+// once and packed into a uint64_t, so sorting and bucketing compare integers
+// instead of concatenated strings.
+
+// Lower-case ASCII with Latin-1 accented letters (UTF-8 U+00C0-U+00FF)
+// folded to their base letter: "José Müller" -> "jose muller".
+std::string asciiFold(std::string_view s);
+
+// American Soundex of one word packed into 14 bits: letter (1-26) in bits
+// 9-13, then three digits of 3 bits each.  0 for a word with no letters.
+// Robert and Rupert are both R163.
+uint16_t soundexCode(std::string_view word);
+
+// First `chars` characters (at most 10) of folded text in 6 bits each,
+// preserving their sort order; shorter text pads with 0 so it sorts first.
+uint64_t packPrefix(std::string_view folded, int chars);
+
+// Lower-cased local part of an email address with any +tag removed.
+std::string_view emailLocalPart(std::string_view email);
+
+// Host of a folded URL without scheme, "www.", port or path:
+// "https://www.example.com:8080/a" -> "example.com".
+std::string_view urlHost(std::string_view url);
+
+// Last `digits` digits (at most 16) of text, 4 bits each with the final
+// digit lowest; fewer digits leave the high nibbles 0.  "+44 7700 900123"
+// and "07700900123" agree, since country and trunk prefixes come first.
+uint64_t packTrailingDigits(std::string_view text, int digits);
+
+// Row key, filled from the leftmost keyed columns until 64 bits are used:
+//   NAME    16 bits  Soundex of the alphabetically first token (so
+//                    "Smith, John" and "john smith" agree)
+//   EMAIL   30 bits  prefix of the local part
+//   URL     30 bits  prefix of the host
+//   PHONE   32 bits  last 8 digits
+//   other   24 bits  prefix of the folded text (GENERIC_TEXT, FREE_TEXT)
+// ID, NUMERIC, BOOLEAN and DATE columns do not contribute.
+uint64_t rowBlockingKey(const std::vector<std::string>& row,
+                        const std::vector<ColumnType>& columnTypes);
+
+#endif
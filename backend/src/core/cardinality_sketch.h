@@ -0,0 +1,44 @@
+#ifndef CARDINALITY_SKETCH_H
+#define CARDINALITY_SKETCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "column_type_detection.h"
+
+class CsvRecordReader;
+
+// HyperLogLog distinct-count sketch over 64-bit hashes: 2^precision one-byte
+// registers, standard error about 1.04 / sqrt(2^precision) (1.6% at the
+// default 12, i.e. 4 KB of state).  Small cardinalities fall back to linear
+// counting, which is close to exact.
+class HyperLogLog {
+public:
+  explicit HyperLogLog(unsigned int precision = 12);
+
+  void add(uint64_t hash);
+  // Union with a sketch of the same precision.
+  void merge(const HyperLogLog& other);
+  double estimate() const;
+
+private:
+  unsigned int precision_;
+  std::vector<uint8_t> registers_;
+};
+
+struct DuplicateEstimate {
+  size_t rows = 0;                         // records read, header included
+  double distinctRows = 0;
+  double duplicateRows = 0;                // rows - distinctRows, never negative
+  std::vector<std::string> columnNames;    // from the header row
+  std::vector<double> columnCardinality;   // distinct non-header values per column
+  std::vector<ColumnType> columnTypes;     // from a ColumnTypeSampler reservoir
+};
+
+// One streaming pass over the reader: a row sketch (header included, like
+// detectDuplicates) plus one smaller sketch and one ColumnTypeSampler per
+// header column, so the column types come from the whole stream too.
+DuplicateEstimate estimateDuplicates(CsvRecordReader& reader);
+
+#endif
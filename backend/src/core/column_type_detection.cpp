@@ -1,8 +1,14 @@
 #include "column_type_detection.h"
-#include "text_normalisation.h"
+#include "parallel_for.h"
+#include "char_class.h"
+#include "perfect_hash.h"
 #include <algorithm>
 #include <cctype>
+#include <cerrno>
 #include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <regex>
 #include <sstream>
 #include <unordered_map>
@@ -11,227 +17,397 @@
 // --- header hint map ----------------------------------------------------
 
 // Split a header name into words delimited by underscore or space, then
-// match each word exactly (or by prefix for compound hints like "updated_at"
-// where "updated" alone should signal DATE).  This avoids false positives
-// from substring matches: "tel" no longer matches "hotel", "id" no longer
-// matches "holiday" or "paid", and "is_"/"has_" now match before underscores
-// are stripped.
-static bool hasWord(const std::vector<std::string>& words, const std::string& candidate) {
-  for (const auto& w : words) if (w == candidate) return true;
-  return false;
-}
+// match each word exactly.  This avoids false positives from substring
+// matches: "tel" no longer matches "hotel", "id" no longer matches "holiday"
+// or "paid", and "is_"/"has_" now match before underscores are stripped.
+// When words hint at different types the earlier type in HINT_PRIORITY wins
+// ("customer_email_name" is EMAIL).
+static constexpr ColumnType HINT_PRIORITY[] = {
+  ColumnType::EMAIL, ColumnType::PHONE, ColumnType::URL, ColumnType::DATE,
+  ColumnType::FREE_TEXT, ColumnType::ID, ColumnType::NAME, ColumnType::NUMERIC,
+  ColumnType::BOOLEAN
+};
+static const uint8_t NO_HINT = sizeof(HINT_PRIORITY) / sizeof(HINT_PRIORITY[0]);
+
+// keyword -> index into HINT_PRIORITY
+static constexpr auto HEADER_KEYWORDS = makePerfectHash<uint8_t, 256>({
+  {"email", 0}, {"mail", 0},
+  {"phone", 1}, {"mobile", 1}, {"tel", 1}, {"telephone", 1}, {"fax", 1},
+  {"url", 2}, {"website", 2}, {"web", 2}, {"link", 2},
+  {"date", 3}, {"dob", 3}, {"birth", 3}, {"timestamp", 3}, {"time", 3},
+  {"created", 3}, {"updated", 3}, {"createdat", 3}, {"updatedat", 3},
+  {"comment", 4}, {"description", 4}, {"note", 4}, {"message", 4},
+  {"review", 4}, {"text", 4}, {"bio", 4},
+  {"id", 5}, {"code", 5}, {"key", 5}, {"uuid", 5}, {"guid", 5}, {"ref", 5},
+  {"name", 6}, {"first", 6}, {"last", 6}, {"full", 6}, {"city", 6},
+  {"state", 6}, {"country", 6}, {"street", 6}, {"address", 6},
+  {"price", 7}, {"cost", 7}, {"amount", 7}, {"salary", 7}, {"age", 7},
+  {"count", 7}, {"number", 7}, {"score", 7}, {"rate", 7}, {"fee", 7},
+  {"rating", 7}, {"stars", 7},
+  {"bool", 8}, {"flag", 8}, {"active", 8}, {"enabled", 8}, {"is", 8}, {"has", 8}
+});
 
 static ColumnType hintFromHeader(const std::string& header) {
-  std::string h = toLowerCase(header);
-
-  // split into words by underscore or space
-  std::vector<std::string> words;
-  std::string current;
-  for (char c : h) {
+  // lower-case each word into a stack buffer; words longer than the longest
+  // keyword cannot match and are skipped without being copied
+  char word[32];
+  static_assert(HEADER_KEYWORDS.maxKeyLength() <= sizeof(word), "keyword buffer too small");
+  size_t len = 0;
+  bool overflow = false;
+  uint8_t best = NO_HINT;
+  auto endWord = [&]() {
+    if (len > 0 && !overflow) {
+      uint8_t rank = HEADER_KEYWORDS.find(std::string_view(word, len), NO_HINT);
+      if (rank < best) best = rank;
+    }
+    len = 0;
+    overflow = false;
+  };
+  for (char c : header) {
     if (c == '_' || c == ' ') {
-      if (!current.empty()) { words.push_back(current); current.clear(); }
+      endWord();
+    } else if (len < HEADER_KEYWORDS.maxKeyLength()) {
+      word[len++] = lowerChar(c);
     } else {
-      current += c;
+      overflow = true;
     }
   }
-  if (!current.empty()) words.push_back(current);
-
-  if (hasWord(words, "email") || hasWord(words, "mail")) return ColumnType::EMAIL;
-  if (hasWord(words, "phone") || hasWord(words, "mobile") ||
-      hasWord(words, "tel") || hasWord(words, "telephone") ||
-      hasWord(words, "fax")) return ColumnType::PHONE;
-  if (hasWord(words, "url") || hasWord(words, "website") ||
-      hasWord(words, "web") || hasWord(words, "link")) return ColumnType::URL;
-  if (hasWord(words, "date") || hasWord(words, "dob") ||
-      hasWord(words, "birth") || hasWord(words, "timestamp") ||
-      hasWord(words, "time") || hasWord(words, "created") ||
-      hasWord(words, "updated") || hasWord(words, "createdat") ||
-      hasWord(words, "updatedat")) return ColumnType::DATE;
-  if (hasWord(words, "comment") || hasWord(words, "description") ||
-      hasWord(words, "note") || hasWord(words, "message") ||
-      hasWord(words, "review") || hasWord(words, "text") ||
-      hasWord(words, "bio")) return ColumnType::FREE_TEXT;
-  if (hasWord(words, "id") || hasWord(words, "code") ||
-      hasWord(words, "key") || hasWord(words, "uuid") ||
-      hasWord(words, "guid") || hasWord(words, "ref")) return ColumnType::ID;
-  if (hasWord(words, "name") || hasWord(words, "first") ||
-      hasWord(words, "last") || hasWord(words, "full") ||
-      hasWord(words, "city") || hasWord(words, "state") ||
-      hasWord(words, "country") || hasWord(words, "street") ||
-      hasWord(words, "address")) return ColumnType::NAME;
-  if (hasWord(words, "price") || hasWord(words, "cost") ||
-      hasWord(words, "amount") || hasWord(words, "salary") ||
-      hasWord(words, "age") || hasWord(words, "count") ||
-      hasWord(words, "number") || hasWord(words, "score") ||
-      hasWord(words, "rate") || hasWord(words, "fee") ||
-      hasWord(words, "rating") || hasWord(words, "stars")) return ColumnType::NUMERIC;
-  if (hasWord(words, "bool") || hasWord(words, "flag") ||
-      hasWord(words, "active") || hasWord(words, "enabled") ||
-      hasWord(words, "is") || hasWord(words, "has")) return ColumnType::BOOLEAN;
-
-  return ColumnType::GENERIC_TEXT;  // no hint matched
+  endWord();
+
+  return best == NO_HINT ? ColumnType::GENERIC_TEXT : HINT_PRIORITY[best];
 }
 
-// --- validators ---------------------------------------------------------
+// --- single-pass value classifier ----------------------------------------
+
+// One bit per validator.  classifyValue() walks a value once and reports
+// every type it matches, replacing nine separate validator passes that each
+// lower-cased, substr'd or threw their way through the same bytes.
+enum MatchBit : uint16_t {
+  MATCH_EMAIL     = 1 << 0,
+  MATCH_DATE      = 1 << 1,
+  MATCH_PHONE     = 1 << 2,
+  MATCH_URL       = 1 << 3,
+  MATCH_NUMERIC   = 1 << 4,
+  MATCH_BOOLEAN   = 1 << 5,
+  MATCH_BOOL_WORD = 1 << 6,  // boolean other than "1"/"0"
+  MATCH_ID        = 1 << 7,
+  MATCH_NAME      = 1 << 8,
+  MATCH_FREE_TEXT = 1 << 9
+};
+static const int MATCH_BIT_COUNT = 10;
+
+// Numeric recogniser: a DFA over the strtod() grammar (decimal, hex float,
+// inf/infinity, nan/nan(...)) in the C locale, fed with spaces and commas
+// already skipped, matching what the old std::stod(stripped) check accepted.
+enum NumClass : uint8_t {
+  NC_OTHER, NC_WS, NC_SIGN, NC_ZERO, NC_DIGIT, NC_DOT, NC_E, NC_P, NC_X,
+  NC_A, NC_F, NC_HEX, NC_I, NC_N, NC_T, NC_Y, NC_WORD, NC_LPAREN, NC_RPAREN,
+  NC_COUNT
+};
 
-static bool isValidEmail(const std::string& s) {
-  // must contain exactly one @, with at least one char before and after,
-  // a dot somewhere after the @, and no whitespace
-  if (s.find(' ') != std::string::npos) return false;
-  size_t at = s.find('@');
-  if (at == std::string::npos || at == 0 || at == s.size() - 1) return false;
-  std::string domain = s.substr(at + 1);
-  if (domain.find('.') == std::string::npos) return false;
-  return true;
-}
+enum NumState : uint8_t {
+  NS_START, NS_SIGN, NS_ZERO, NS_INT, NS_DOT, NS_FRAC, NS_EXP, NS_EXP_SIGN, NS_EXP_DIG,
+  NS_HEX0, NS_HEX_INT, NS_HEX_DOT, NS_HEX_FRAC, NS_HEX_EXP, NS_HEX_EXP_SIGN, NS_HEX_EXP_DIG,
+  NS_I, NS_IN, NS_INF, NS_INFI, NS_INFIN, NS_INFINI, NS_INFINIT, NS_INFINITY,
+  NS_N, NS_NA, NS_NAN, NS_NAN_SEQ, NS_NAN_END,
+  NS_DEAD, NS_COUNT
+};
 
-static bool isValidURL(const std::string& s) {
-  std::string lower = toLowerCase(s);
-  if (lower.find("http://") == 0 || lower.find("https://") == 0) return true;
-  if (lower.find("www.") == 0) return true;
-  // common TLD pattern
-  if (lower.find(".com") != std::string::npos ||
-      lower.find(".org") != std::string::npos ||
-      lower.find(".net") != std::string::npos ||
-      lower.find(".io")  != std::string::npos) {
-    return lower.find(' ') == std::string::npos;
+static constexpr NumClass numClassOf(int c) {
+  if (c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r') return NC_WS;
+  if (c == '+' || c == '-') return NC_SIGN;
+  if (c == '0') return NC_ZERO;
+  if (c >= '1' && c <= '9') return NC_DIGIT;
+  if (c == '.') return NC_DOT;
+  if (c == '(') return NC_LPAREN;
+  if (c == ')') return NC_RPAREN;
+  if (c == '_') return NC_WORD;
+  if (c >= 'A' && c <= 'Z') c += 32;
+  switch (c) {
+    case 'e': return NC_E;
+    case 'p': return NC_P;
+    case 'x': return NC_X;
+    case 'a': return NC_A;
+    case 'f': return NC_F;
+    case 'b': case 'c': case 'd': return NC_HEX;
+    case 'i': return NC_I;
+    case 'n': return NC_N;
+    case 't': return NC_T;
+    case 'y': return NC_Y;
+    default: break;
   }
-  return false;
+  return (c >= 'a' && c <= 'z') ? NC_WORD : NC_OTHER;
 }
 
-static bool isValidPhone(const std::string& s) {
-  // count digits after stripping common separators
-  int digits = 0;
-  bool hasFormatting = false;
-  for (char c : s) {
-    if (c >= '0' && c <= '9') digits++;
-    else if (c != ' ' && c != '-' && c != '.' && c != '(' && c != ')' && c != '+')
-      return false; // unexpected character
-    else
-      hasFormatting = true;
-  }
-  if (digits < 7) return false;
-  // Reject values that parse cleanly as numbers (e.g. 1,234,567 or 12.34)
-  // — those belong to NUMERIC, not PHONE. Real phone numbers like
-  // +1-555-1234 survive because they don't parse as a single number, and
-  // separator-free internationals like +447700900123 are exempt because a
-  // leading '+' is a phone prefix, not a numeric sign, in real data.
-  if (s[0] != '+') {
-    std::string stripped;
-    for (char c : s) {
-      if (c != ' ' && c != ',') stripped += c;
-    }
-    try {
-      size_t pos = 0;
-      std::stod(stripped, &pos);
-      if (pos == stripped.size()) return false;
-    } catch (...) {}
+static constexpr NumState numStep(NumState s, NumClass c) {
+  const bool digit = c == NC_ZERO || c == NC_DIGIT;
+  const bool hex = digit || c == NC_A || c == NC_F || c == NC_HEX || c == NC_E;
+  const bool word = hex || c == NC_P || c == NC_X || c == NC_I || c == NC_N ||
+                    c == NC_T || c == NC_Y || c == NC_WORD;
+  switch (s) {
+    case NS_START:
+      if (c == NC_WS) return NS_START;
+      [[fallthrough]];  // after leading whitespace the sign is optional
+    case NS_SIGN:
+      if (c == NC_SIGN && s == NS_START) return NS_SIGN;
+      if (c == NC_ZERO) return NS_ZERO;
+      if (c == NC_DIGIT) return NS_INT;
+      if (c == NC_DOT) return NS_DOT;
+      if (c == NC_I) return NS_I;
+      if (c == NC_N) return NS_N;
+      return NS_DEAD;
+    case NS_ZERO:
+      if (c == NC_X) return NS_HEX0;
+      [[fallthrough]];  // otherwise a leading zero is an ordinary digit
+    case NS_INT:
+      if (digit) return NS_INT;
+      if (c == NC_DOT) return NS_FRAC;
+      if (c == NC_E) return NS_EXP;
+      return NS_DEAD;
+    case NS_DOT:
+      return digit ? NS_FRAC : NS_DEAD;
+    case NS_FRAC:
+      if (digit) return NS_FRAC;
+      if (c == NC_E) return NS_EXP;
+      return NS_DEAD;
+    case NS_EXP:
+      if (c == NC_SIGN) return NS_EXP_SIGN;
+      return digit ? NS_EXP_DIG : NS_DEAD;
+    case NS_EXP_SIGN:
+    case NS_EXP_DIG:
+      return digit ? NS_EXP_DIG : NS_DEAD;
+    case NS_HEX0:
+      if (hex) return NS_HEX_INT;
+      return c == NC_DOT ? NS_HEX_DOT : NS_DEAD;
+    case NS_HEX_INT:
+      if (hex) return NS_HEX_INT;
+      if (c == NC_DOT) return NS_HEX_FRAC;
+      return c == NC_P ? NS_HEX_EXP : NS_DEAD;
+    case NS_HEX_DOT:
+      return hex ? NS_HEX_FRAC : NS_DEAD;
+    case NS_HEX_FRAC:
+      if (hex) return NS_HEX_FRAC;
+      return c == NC_P ? NS_HEX_EXP : NS_DEAD;
+    case NS_HEX_EXP:
+      if (c == NC_SIGN) return NS_HEX_EXP_SIGN;
+      return digit ? NS_HEX_EXP_DIG : NS_DEAD;
+    case NS_HEX_EXP_SIGN:
+    case NS_HEX_EXP_DIG:
+      return digit ? NS_HEX_EXP_DIG : NS_DEAD;
+    case NS_I:       return c == NC_N ? NS_IN : NS_DEAD;
+    case NS_IN:      return c == NC_F ? NS_INF : NS_DEAD;
+    case NS_INF:     return c == NC_I ? NS_INFI : NS_DEAD;
+    case NS_INFI:    return c == NC_N ? NS_INFIN : NS_DEAD;
+    case NS_INFIN:   return c == NC_I ? NS_INFINI : NS_DEAD;
+    case NS_INFINI:  return c == NC_T ? NS_INFINIT : NS_DEAD;
+    case NS_INFINIT: return c == NC_Y ? NS_INFINITY : NS_DEAD;
+    case NS_N:       return c == NC_A ? NS_NA : NS_DEAD;
+    case NS_NA:      return c == NC_N ? NS_NAN : NS_DEAD;
+    case NS_NAN:     return c == NC_LPAREN ? NS_NAN_SEQ : NS_DEAD;
+    case NS_NAN_SEQ:
+      if (word) return NS_NAN_SEQ;
+      return c == NC_RPAREN ? NS_NAN_END : NS_DEAD;
+    default:
+      return NS_DEAD;
   }
-  return true;
 }
 
-static bool isValidDate(const std::string& s) {
-  // ISO: YYYY-MM-DD or YYYY/MM/DD
-  if (s.size() == 10 && s[4] == '-' && s[7] == '-') {
-    int y = 0, m = 0, d = 0;
-    try { y = std::stoi(s.substr(0, 4)); m = std::stoi(s.substr(5, 2)); d = std::stoi(s.substr(8, 2)); }
-    catch (...) { return false; }
-    return y >= 1900 && y <= 2100 && m >= 1 && m <= 12 && d >= 1 && d <= 31;
-  }
-  if (s.size() == 10 && s[4] == '/' && s[7] == '/') {
-    int y = 0, m = 0, d = 0;
-    try { y = std::stoi(s.substr(0, 4)); m = std::stoi(s.substr(5, 2)); d = std::stoi(s.substr(8, 2)); }
-    catch (...) { return false; }
-    return y >= 1900 && y <= 2100 && m >= 1 && m <= 12 && d >= 1 && d <= 31;
-  }
-  // DD/MM/YYYY
-  if (s.size() == 10 && s[2] == '/' && s[5] == '/') {
-    int d = 0, m = 0, y = 0;
-    try { d = std::stoi(s.substr(0, 2)); m = std::stoi(s.substr(3, 2)); y = std::stoi(s.substr(6, 4)); }
-    catch (...) { return false; }
-    return y >= 1900 && y <= 2100 && m >= 1 && m <= 12 && d >= 1 && d <= 31;
-  }
-  // DD-MM-YYYY
-  if (s.size() == 10 && s[2] == '-' && s[5] == '-') {
-    int d = 0, m = 0, y = 0;
-    try { d = std::stoi(s.substr(0, 2)); m = std::stoi(s.substr(3, 2)); y = std::stoi(s.substr(6, 4)); }
-    catch (...) { return false; }
-    return y >= 1900 && y <= 2100 && m >= 1 && m <= 12 && d >= 1 && d <= 31;
-  }
-  return false;
+static constexpr bool numAccepting(NumState s) {
+  return s == NS_ZERO || s == NS_INT || s == NS_FRAC || s == NS_EXP_DIG ||
+         s == NS_HEX_INT || s == NS_HEX_FRAC || s == NS_HEX_EXP_DIG ||
+         s == NS_INF || s == NS_INFINITY || s == NS_NAN || s == NS_NAN_END;
 }
 
-static bool isValidNumeric(const std::string& s) {
-  if (s.empty()) return false;
-  std::string trimmed;
-  for (char c : s) {
-    if (c != ' ' && c != ',') trimmed += c;  // allow commas as thousand separators
-  }
-  try {
-    size_t pos = 0;
-    std::stod(trimmed, &pos);
-    return pos == trimmed.size();  // whole string consumed
-  } catch (...) {
-    return false;
-  }
-}
+struct NumTables {
+  uint8_t cls[256];
+  uint8_t next[NS_COUNT][NC_COUNT];
+};
 
-static bool isValidBoolean(const std::string& s) {
-  std::string lower = toLowerCase(s);
-  return lower == "true" || lower == "false" ||
-         lower == "yes" || lower == "no" ||
-         lower == "1" || lower == "0" ||
-         lower == "t" || lower == "f" ||
-         lower == "y" || lower == "n";
+static constexpr NumTables makeNumTables() {
+  NumTables t{};
+  for (int c = 0; c < 256; c++) t.cls[c] = numClassOf(c);
+  for (int s = 0; s < NS_COUNT; s++)
+    for (int c = 0; c < NC_COUNT; c++)
+      t.next[s][c] = numStep(static_cast<NumState>(s), static_cast<NumClass>(c));
+  return t;
+}
+static constexpr NumTables NUM_TABLES = makeNumTables();
+
+// std::stod throws out_of_range when strtod reports ERANGE.  Only values
+// with an exponent, a hex mantissa or hundreds of digits can get there, so
+// the real strtod is consulted for just those (on a stack buffer unless the
+// value is enormous).
+static bool numericInRange(const std::string& s) {
+  char stackBuf[128];
+  std::string heapBuf;
+  char* buf = stackBuf;
+  if (s.size() >= sizeof(stackBuf)) { heapBuf.resize(s.size() + 1); buf = &heapBuf[0]; }
+  size_t n = 0;
+  for (char c : s) if (c != ' ' && c != ',') buf[n++] = c;
+  buf[n] = '\0';
+  int savedErrno = errno;
+  errno = 0;
+  std::strtod(buf, nullptr);
+  bool ok = errno != ERANGE;
+  errno = savedErrno;
+  return ok;
 }
 
-static bool isValidID(const std::string& s) {
-  if (s.empty()) return false;
-  // alphanumeric with optional dashes/underscores, 3-50 chars
-  if (s.size() < 3 || s.size() > 50) return false;
-  for (char c : s) {
-    if (!((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') ||
-          (c >= '0' && c <= '9') || c == '-' || c == '_'))
-      return false;
-  }
+// std::stoi on a short fixed-width field: optional leading C-locale
+// whitespace, optional sign, then at least one digit; trailing junk ignored.
+static bool stoiField(const char* p, size_t n, int& out) {
+  size_t i = 0;
+  while (i < n && (charClass(p[i]) & CC_CSPACE)) i++;
+  bool neg = false;
+  if (i < n && (p[i] == '+' || p[i] == '-')) neg = p[i++] == '-';
+  if (i >= n || !(charClass(p[i]) & CC_DIGIT)) return false;
+  int v = 0;
+  while (i < n && (charClass(p[i]) & CC_DIGIT)) v = v * 10 + (p[i++] - '0');
+  out = neg ? -v : v;
   return true;
 }
 
-static bool isValidName(const std::string& s) {
-  if (s.empty()) return false;
-  // mostly alphabetic and spaces, with occasional hyphens/apostrophes
-  int alpha = 0, other = 0;
-  for (char c : s) {
-    if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || c == ' ') alpha++;
-    else if (c == '-' || c == '\'' || c == '.') other++;
-    else return false;
+// YYYY-MM-DD, YYYY/MM/DD, DD/MM/YYYY or DD-MM-YYYY with year 1900-2100
+static bool matchesDate(const std::string& s) {
+  if (s.size() != 10) return false;
+  const char* p = s.data();
+  int y = 0, m = 0, d = 0;
+  if ((p[4] == '-' && p[7] == '-') || (p[4] == '/' && p[7] == '/')) {
+    if (!stoiField(p, 4, y) || !stoiField(p + 5, 2, m) || !stoiField(p + 8, 2, d)) return false;
+  } else if ((p[2] == '/' && p[5] == '/') || (p[2] == '-' && p[5] == '-')) {
+    if (!stoiField(p, 2, d) || !stoiField(p + 3, 2, m) || !stoiField(p + 6, 4, y)) return false;
+  } else {
+    return false;
   }
-  return alpha > 0 && (alpha + other) == (int)s.size();
+  return y >= 1900 && y <= 2100 && m >= 1 && m <= 12 && d >= 1 && d <= 31;
 }
 
-static bool looksLikeFreeText(const std::string& s) {
-  // longer strings, or strings with sentence punctuation
-  if (s.size() > 50) return true;
-  for (char c : s) {
-    if (c == '.' || c == '!' || c == '?' || c == ',' || c == ';' || c == ':')
-      return true;
+static uint32_t pack4(const char* s) {
+  return (uint32_t)(uint8_t)s[0] << 24 | (uint32_t)(uint8_t)s[1] << 16 |
+         (uint32_t)(uint8_t)s[2] << 8 | (uint32_t)(uint8_t)s[3];
+}
+
+static uint16_t classifyValue(const std::string& s) {
+  const size_t n = s.size();
+  if (n == 0) return 0;
+
+  static const uint32_t TLD_COM = pack4(".com"), TLD_ORG = pack4(".org"),
+                        TLD_NET = pack4(".net"), TLD_IO = pack4("\0.io") & 0xFFFFFF;
+
+  uint8_t any = 0;           // OR of character classes over the value
+  uint8_t every = 0xFF;      // AND of character classes over the value
+  bool hasSpace = false, nameLetter = false, tld = false, dotAfterAt = false;
+  size_t at = std::string::npos;
+  int digits = 0;
+  char head[8] = {0};        // leading bytes, lower-cased
+  uint32_t tail = 0;         // trailing four bytes, lower-cased
+  NumState num = NS_START;
+  size_t numDigits = 0;
+  bool numNeedsRange = false;
+
+  for (size_t i = 0; i < n; i++) {
+    const char c = s[i];
+    const uint8_t cls = charClass(c);
+    const char lc = lowerChar(c);
+    any |= cls;
+    every &= cls;
+    if (cls & CC_DIGIT) digits++;
+    if (c == ' ') hasSpace = true;
+    if ((cls & CC_ALPHA) || c == ' ') nameLetter = true;
+    if (c == '@' && at == std::string::npos) at = i;
+    else if (c == '.' && at != std::string::npos) dotAfterAt = true;
+    if (i < sizeof(head)) head[i] = lc;
+    tail = (tail << 8) | (uint8_t)lc;
+    if (i >= 3 && (tail == TLD_COM || tail == TLD_ORG || tail == TLD_NET)) tld = true;
+    if (i >= 2 && (tail & 0xFFFFFF) == TLD_IO) tld = true;
+
+    if (c != ' ' && c != ',' && num != NS_DEAD) {
+      NumClass nc = static_cast<NumClass>(NUM_TABLES.cls[(unsigned char)c]);
+      num = static_cast<NumState>(NUM_TABLES.next[num][nc]);
+      if (nc == NC_ZERO || nc == NC_DIGIT) numDigits++;
+      if (num == NS_EXP || num == NS_HEX0 || num == NS_HEX_EXP) numNeedsRange = true;
+    }
+  }
+
+  uint16_t bits = 0;
+
+  // exactly-one-@ is not enforced: the first @ must have text on both sides
+  // and a dot somewhere after it, with no spaces anywhere
+  if (!hasSpace && at != std::string::npos && at != 0 && at != n - 1 && dotAfterAt)
+    bits |= MATCH_EMAIL;
+
+  if ((n >= 7 && std::memcmp(head, "http://", 7) == 0) ||
+      (n >= 8 && std::memcmp(head, "https://", 8) == 0) ||
+      (n >= 4 && std::memcmp(head, "www.", 4) == 0) ||
+      (tld && !hasSpace))
+    bits |= MATCH_URL;
+
+  if (matchesDate(s)) bits |= MATCH_DATE;
+
+  bool numeric = numAccepting(num) &&
+                 (!(numNeedsRange || numDigits > 300) || numericInRange(s));
+  if (numeric) bits |= MATCH_NUMERIC;
+
+  // Values that parse cleanly as numbers (e.g. 1234567 or 12.34) belong to
+  // NUMERIC, not PHONE — unless they carry a leading '+', which is a phone
+  // prefix rather than a numeric sign in real data (+447700900123).
+  if ((every & CC_PHONE) && digits >= 7 && (s[0] == '+' || !numeric))
+    bits |= MATCH_PHONE;
+
+  if (n <= 5) {
+    bool word = (n == 4 && std::memcmp(head, "true", 4) == 0) ||
+                (n == 5 && std::memcmp(head, "false", 5) == 0) ||
+                (n == 3 && std::memcmp(head, "yes", 3) == 0) ||
+                (n == 2 && std::memcmp(head, "no", 2) == 0) ||
+                (n == 1 && (head[0] == 't' || head[0] == 'f' || head[0] == 'y' || head[0] == 'n'));
+    if (word) bits |= MATCH_BOOLEAN | MATCH_BOOL_WORD;
+    else if (n == 1 && (head[0] == '1' || head[0] == '0')) bits |= MATCH_BOOLEAN;
   }
-  return false;
+
+  if (n >= 3 && n <= 50 && (every & CC_ID)) bits |= MATCH_ID;
+  if ((every & CC_NAME) && nameLetter) bits |= MATCH_NAME;
+  if (n > 50 || (any & CC_SENTENCE)) bits |= MATCH_FREE_TEXT;
+  return bits;
 }
 
 // --- scoring ------------------------------------------------------------
 
 static const int SAMPLE_SIZE = 200;
 
-static std::vector<std::string> sampleColumn(const std::vector<std::vector<std::string>>& data,
-                                             size_t colIdx) {
-  std::vector<std::string> sample;
-  for (size_t row = 1; row < data.size() && sample.size() < (size_t)SAMPLE_SIZE; row++) {
+// Per-column tallies over the classified sample.
+struct TypeCounts {
+  size_t values = 0;
+  size_t totalLength = 0;
+  size_t matches[MATCH_BIT_COUNT] = {};
+
+  void add(const std::string& v) {
+    values++;
+    totalLength += v.size();
+    uint16_t bits = classifyValue(v);
+    for (int b = 0; b < MATCH_BIT_COUNT; b++) matches[b] += (bits >> b) & 1;
+  }
+  void merge(const TypeCounts& other) {
+    values += other.values;
+    totalLength += other.totalLength;
+    for (int b = 0; b < MATCH_BIT_COUNT; b++) matches[b] += other.matches[b];
+  }
+  size_t count(MatchBit bit) const {
+    int b = 0;
+    while ((1u << b) != bit) b++;
+    return matches[b];
+  }
+  double share(MatchBit bit) const { return (double)count(bit) / (double)values; }
+};
+
+static TypeCounts sampleColumn(const std::vector<std::vector<std::string>>& data,
+                               size_t colIdx) {
+  TypeCounts counts;
+  for (size_t row = 1; row < data.size() && counts.values < (size_t)SAMPLE_SIZE; row++) {
     if (colIdx < data[row].size() && !data[row][colIdx].empty()) {
-      sample.push_back(data[row][colIdx]);
+      counts.add(data[row][colIdx]);
     }
   }
-  return sample;
+  return counts;
 }
 
 struct TypeScore {
@@ -239,50 +415,29 @@ struct TypeScore {
   double score;
 };
 
-static ColumnType detectOneColumn(const std::vector<std::vector<std::string>>& data,
-                                  size_t colIdx,
-                                  const std::string& headerName) {
-  std::vector<std::string> sample = sampleColumn(data, colIdx);
-  if (sample.empty()) {
+static ColumnType decideColumnType(const TypeCounts& counts, const std::string& headerName) {
+  if (counts.values == 0) {
     // no non-empty data — fall back to header hint
     return hintFromHeader(headerName);
   }
 
-  // score each type
-  std::vector<TypeScore> scores;
-
-  auto scoreType = [&](ColumnType t, auto validator) -> double {
-    if (sample.empty()) return 0.0;
-    int matches = 0;
-    for (const auto& v : sample) {
-      if (validator(v)) matches++;
-    }
-    return (double)matches / (double)sample.size();
-  };
-
   // evaluate in deterministic precedence order — DATE before PHONE because
   // ISO dates (e.g. 2024-01-15) also pass the phone validator (8 digits with
   // dashes), and ties keep the first evaluated type
-  scores.push_back({ColumnType::EMAIL,       scoreType(ColumnType::EMAIL, isValidEmail)});
-  scores.push_back({ColumnType::DATE,        scoreType(ColumnType::DATE, isValidDate)});
-  scores.push_back({ColumnType::PHONE,       scoreType(ColumnType::PHONE, isValidPhone)});
-  scores.push_back({ColumnType::URL,         scoreType(ColumnType::URL, isValidURL)});
-  scores.push_back({ColumnType::NUMERIC,     scoreType(ColumnType::NUMERIC, isValidNumeric)});
-  scores.push_back({ColumnType::BOOLEAN,     scoreType(ColumnType::BOOLEAN, isValidBoolean)});
-  scores.push_back({ColumnType::ID,          scoreType(ColumnType::ID, isValidID)});
-  scores.push_back({ColumnType::NAME,        scoreType(ColumnType::NAME, isValidName)});
+  std::vector<TypeScore> scores;
+  scores.push_back({ColumnType::EMAIL,       counts.share(MATCH_EMAIL)});
+  scores.push_back({ColumnType::DATE,        counts.share(MATCH_DATE)});
+  scores.push_back({ColumnType::PHONE,       counts.share(MATCH_PHONE)});
+  scores.push_back({ColumnType::URL,         counts.share(MATCH_URL)});
+  scores.push_back({ColumnType::NUMERIC,     counts.share(MATCH_NUMERIC)});
+  scores.push_back({ColumnType::BOOLEAN,     counts.share(MATCH_BOOLEAN)});
+  scores.push_back({ColumnType::ID,          counts.share(MATCH_ID)});
+  scores.push_back({ColumnType::NAME,        counts.share(MATCH_NAME)});
 
   // FREE_TEXT: average length > 50 or contains sentence punctuation
   {
-    int freeTextMatches = 0;
-    for (const auto& v : sample) {
-      if (looksLikeFreeText(v)) freeTextMatches++;
-    }
-    double avgLen = 0;
-    for (const auto& v : sample) avgLen += v.size();
-    avgLen /= sample.size();
-    double ftScore = std::max((double)freeTextMatches / sample.size(),
-                              avgLen > 50 ? 0.7 : 0.0);
+    double avgLen = (double)counts.totalLength / counts.values;
+    double ftScore = std::max(counts.share(MATCH_FREE_TEXT), avgLen > 50 ? 0.7 : 0.0);
     scores.push_back({ColumnType::FREE_TEXT, ftScore});
   }
 
@@ -314,28 +469,11 @@ static ColumnType detectOneColumn(const std::vector<std::vector<std::string>>& d
   // BOOLEAN guard: if all boolean matches are purely numeric (0/1) and
   // NUMERIC also scored ≥70%, prefer NUMERIC — numeric values dominated by
   // 0/1 (ratings, flags) should not become "true"/"false".
-  if (bestType == ColumnType::BOOLEAN) {
-    bool hasNonNumericBool = false;
-    for (const auto& v : sample) {
-      std::string lower = toLowerCase(v);
-      if (lower == "true" || lower == "false" ||
-          lower == "yes" || lower == "no" ||
-          lower == "t" || lower == "f" ||
-          lower == "y" || lower == "n") {
-        hasNonNumericBool = true;
-        break;
-      }
-    }
-    if (!hasNonNumericBool) {
-      // find the NUMERIC score
-      double numericScore = 0.0;
-      for (const auto& s : scores) {
-        if (s.type == ColumnType::NUMERIC) { numericScore = s.score; break; }
-      }
-      // boost numeric if header hint agrees
-      if (hintType == ColumnType::NUMERIC) numericScore = std::min(1.0, numericScore + 0.15);
-      if (numericScore >= 0.70) bestType = ColumnType::NUMERIC;
-    }
+  if (bestType == ColumnType::BOOLEAN && counts.count(MATCH_BOOL_WORD) == 0) {
+    double numericScore = counts.share(MATCH_NUMERIC);
+    // boost numeric if header hint agrees
+    if (hintType == ColumnType::NUMERIC) numericScore = std::min(1.0, numericScore + 0.15);
+    if (numericScore >= 0.70) bestType = ColumnType::NUMERIC;
   }
 
   // if nothing reached 70%, use the header hint if available
@@ -348,6 +486,12 @@ static ColumnType detectOneColumn(const std::vector<std::vector<std::string>>& d
   return bestType;
 }
 
+static ColumnType detectOneColumn(const std::vector<std::vector<std::string>>& data,
+                                  size_t colIdx,
+                                  const std::string& headerName) {
+  return decideColumnType(sampleColumn(data, colIdx), headerName);
+}
+
 // --- public API ---------------------------------------------------------
 
 ColumnTypeResult detectColumnTypes(const std::vector<std::vector<std::string>>& data) {
@@ -364,6 +508,82 @@ ColumnTypeResult detectColumnTypes(const std::vector<std::vector<std::string>>&
   return result;
 }
 
+static const size_t MIN_ROWS_PER_THREAD = 4096;
+
+ColumnTypeResult detectColumnTypesFull(const std::vector<std::vector<std::string>>& data,
+                                       unsigned int threadCount) {
+  ColumnTypeResult result;
+  if (data.empty() || data[0].empty()) return result;
+
+  const auto& headers = data[0];
+  const size_t nCols = headers.size();
+  result.names = headers;
+
+  // each worker tallies a contiguous block of data rows for every column;
+  // the per-type match counters are then summed column by column
+  size_t dataRows = data.size() - 1;
+  unsigned int threads = workerCount(dataRows, MIN_ROWS_PER_THREAD, threadCount);
+  std::vector<std::vector<TypeCounts>> partial(threads, std::vector<TypeCounts>(nCols));
+  parallelChunks(dataRows, threads, [&](unsigned int t, size_t begin, size_t end) {
+    auto& counts = partial[t];
+    for (size_t row = begin + 1; row < end + 1; row++) {
+      const auto& r = data[row];
+      size_t n = std::min(r.size(), nCols);
+      for (size_t col = 0; col < n; col++) {
+        if (!r[col].empty()) counts[col].add(r[col]);
+      }
+    }
+  });
+
+  result.types.resize(nCols, ColumnType::GENERIC_TEXT);
+  for (size_t col = 0; col < nCols; col++) {
+    TypeCounts merged;
+    for (const auto& counts : partial) merged.merge(counts[col]);
+    result.types[col] = decideColumnType(merged, headers[col]);
+  }
+  return result;
+}
+
+// --- streaming sampler --------------------------------------------------
+
+ColumnTypeSampler::ColumnTypeSampler(const std::vector<std::string>& headers,
+                                     size_t reservoirSize, uint64_t seed)
+    : headers_(headers),
+      reservoirSize_(reservoirSize ? reservoirSize : SAMPLE_SIZE),
+      reservoirs_(headers.size()),
+      seen_(headers.size(), 0),
+      rng_(seed) {}
+
+void ColumnTypeSampler::addRow(const std::vector<std::string>& row) {
+  size_t n = std::min(row.size(), headers_.size());
+  for (size_t col = 0; col < n; col++) {
+    const std::string& v = row[col];
+    if (v.empty()) continue;
+    // Algorithm R: the k-th value replaces a random slot with probability
+    // reservoirSize/k, so every non-empty value is equally likely to be kept
+    uint64_t k = ++seen_[col];
+    auto& res = reservoirs_[col];
+    if (res.size() < reservoirSize_) {
+      res.push_back(v);
+    } else {
+      uint64_t slot = rng_() % k;
+      if (slot < reservoirSize_) res[slot] = v;
+    }
+  }
+}
+
+ColumnTypeResult ColumnTypeSampler::finish() const {
+  ColumnTypeResult result;
+  result.names = headers_;
+  result.types.resize(headers_.size(), ColumnType::GENERIC_TEXT);
+  for (size_t col = 0; col < headers_.size(); col++) {
+    TypeCounts counts;
+    for (const auto& v : reservoirs_[col]) counts.add(v);
+    result.types[col] = decideColumnType(counts, headers_[col]);
+  }
+  return result;
+}
+
 const char* columnTypeToString(ColumnType t) {
   switch (t) {
     case ColumnType::EMAIL:         return "EMAIL";
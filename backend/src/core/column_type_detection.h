@@ -3,6 +3,8 @@
 
 #include <vector>
 #include <string>
+#include <cstdint>
+#include <random>
 
 enum class ColumnType {
   EMAIL,
@@ -22,7 +24,31 @@ struct ColumnTypeResult {
   std::vector<std::string> names;
 };
 
+// Types each column from its first 200 non-empty values.
 ColumnTypeResult detectColumnTypes(const std::vector<std::vector<std::string>>& data);
+// Types each column from every non-empty value, with row chunks classified
+// on worker threads (threadCount 0 = hardware concurrency).
+ColumnTypeResult detectColumnTypesFull(const std::vector<std::vector<std::string>>& data,
+                                       unsigned int threadCount = 0);
+
+// Column typing for streamed input: rows are fed one at a time and each
+// column keeps a fixed-size reservoir sample spread over the whole stream,
+// so late format changes are seen without holding the data in memory.
+class ColumnTypeSampler {
+public:
+  explicit ColumnTypeSampler(const std::vector<std::string>& headers,
+                             size_t reservoirSize = 0, uint64_t seed = 0x5eed);
+  void addRow(const std::vector<std::string>& row);
+  ColumnTypeResult finish() const;
+
+private:
+  std::vector<std::string> headers_;
+  size_t reservoirSize_;
+  std::vector<std::vector<std::string>> reservoirs_;
+  std::vector<uint64_t> seen_;
+  std::mt19937_64 rng_;
+};
+
 const char* columnTypeToString(ColumnType t);
 double typeWeight(ColumnType t);
 
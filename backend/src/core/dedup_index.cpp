@@ -0,0 +1,454 @@
+#include "dedup_index.h"
+#include "blocking_keys.h"
+#include "row_hash.h"
+#include "sha256.h"
+#include "similarity_kernels.h"
+#include "string_issue_detectors.h"
+#include "weighted_dedup.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+static const int FUZZY_CANDIDATES = 20;  // same budget as the in-memory blocking window
+static const char INDEX_MAGIC[8] = {'T', 'K', 'D', 'D', 'I', 'D', 'X', '\n'};
+static const uint32_t INDEX_VERSION = 2;  // 2: blocking keys stored hashed
+
+// --- stable hashing ------------------------------------------------------
+
+// row_hash.h's hashes load words in host byte order and may change between
+// builds; the index outlives both, so it hashes with explicit little-endian
+// loads under its own format version.
+
+static uint64_t loadLittleEndian(const unsigned char* p, size_t n) {
+  uint64_t w = 0;
+  for (size_t i = 0; i < n; i++) w |= static_cast<uint64_t>(p[i]) << (8 * i);
+  return w;
+}
+
+static uint64_t stableHash(const std::string& s, uint64_t seed) {
+  const uint64_t K = 0x9e3779b97f4a7c15ULL;
+  const unsigned char* p = reinterpret_cast<const unsigned char*>(s.data());
+  const size_t n = s.size();
+  uint64_t h = seed ^ (n * K);
+  if (n <= 8) return hashMix(h ^ loadLittleEndian(p, n));
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) h = (h ^ hashMix(loadLittleEndian(p + i, 8))) * K;
+  if (i < n) h = (h ^ hashMix(loadLittleEndian(p + n - 8, 8))) * K;
+  return hashMix(h);
+}
+
+static uint64_t stableRowHash(const std::vector<std::string>& row, uint64_t seed) {
+  uint64_t h = seed ^ row.size();
+  for (const auto& cell : row) h = stableHash(cell, h);
+  return h;
+}
+
+// Hash of the form a cell is compared in; 0 is reserved for an empty cell.
+static uint64_t columnHash(const std::string& cell, ColumnType type) {
+  if (cell.empty()) return 0;
+  std::string form;
+  switch (type) {
+    case ColumnType::NAME:
+    case ColumnType::FREE_TEXT:
+      form = sortedTokens(cell);
+      break;
+    case ColumnType::GENERIC_TEXT:
+      form = normalizeForComparison(cell);
+      break;
+    default:
+      form = normaliseForType(cell, type);
+      break;
+  }
+  uint64_t h = stableHash(form, 0x452821e638d01377ULL);
+  return h ? h : 1;
+}
+
+// --- file format ---------------------------------------------------------
+
+// magic[8] version:u32 columns:u32 headerHash:u64 rows:u64 types:u8[columns]
+// then per row: hashLo:u64 hashHi:u64 blockKeyHash:u64 columnHash:u64[columns],
+// all little-endian.  Records are appended after the header; the row count
+// is written last, so bytes past `rows` records are an unfinished append and
+// are ignored.
+
+static const std::streamoff ROW_COUNT_OFFSET = 24;
+
+static std::streamoff recordsOffset(size_t columns) { return 32 + static_cast<std::streamoff>(columns); }
+static size_t recordSize(size_t columns) { return (3 + columns) * 8; }
+
+static void putU32(std::string& out, uint32_t v) {
+  for (int i = 0; i < 4; i++) out += static_cast<char>((v >> (8 * i)) & 0xFF);
+}
+
+static void putU64(std::string& out, uint64_t v) {
+  for (int i = 0; i < 8; i++) out += static_cast<char>((v >> (8 * i)) & 0xFF);
+}
+
+class IndexReader {
+public:
+  explicit IndexReader(const std::string& bytes) : bytes_(bytes) {}
+  uint64_t u64() { return loadLittleEndian(take(8), 8); }
+  uint32_t u32() { return static_cast<uint32_t>(loadLittleEndian(take(4), 4)); }
+  uint8_t u8() { return *take(1); }
+  const unsigned char* take(size_t n) {
+    if (bytes_.size() - pos_ < n) throw std::runtime_error("dedup index: truncated index file");
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(bytes_.data()) + pos_;
+    pos_ += n;
+    return p;
+  }
+  size_t remaining() const { return bytes_.size() - pos_; }
+
+private:
+  const std::string& bytes_;
+  size_t pos_ = 0;
+};
+
+// --- directory -----------------------------------------------------------
+
+std::string getDedupIndexDirectory() {
+  const char* env = std::getenv("TOOLKIT_DEDUP_INDEX_DIR");
+  std::string dir = env && *env ? std::string(env) : "/tmp/toolkit_dedup_index";
+  if (dir.size() > 1 && dir.back() == '/') dir.pop_back();
+  fs::create_directories(dir);
+  fs::permissions(dir, fs::perms::owner_all, fs::perm_options::replace);
+  return dir;
+}
+
+static bool isNameChars(const std::string& s) {
+  for (char c : s) {
+    bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+              c == '_' || c == '-';
+    if (!ok) return false;
+  }
+  return true;
+}
+
+bool isValidIndexName(const std::string& name) {
+  return !name.empty() && name.size() <= 64 && isNameChars(name);
+}
+
+bool isValidIndexToken(const std::string& token) {
+  return token.size() >= 32 && token.size() <= 128 && isNameChars(token);
+}
+
+std::string indexNameForToken(const std::string& token) { return sha256Hex(token); }
+
+// Removes an index and its lock file, unless another request holds the
+// lock.  The lock is taken before anything is unlinked, and a request that
+// was waiting on the unlinked lock notices and re-locks (see the constructor).
+static void removeIndexUnlessLocked(const fs::path& idx, const fs::path& lock) {
+  int fd = open(lock.c_str(), O_CREAT | O_RDWR, 0600);
+  if (fd == -1) return;
+  if (flock(fd, LOCK_EX | LOCK_NB) == 0) {
+    std::error_code ec;
+    fs::remove(idx, ec);
+    fs::remove(lock, ec);
+  }
+  close(fd);
+}
+
+// Remove indexes not written within the 30-day retention window, and lock
+// files left by indexes that were never saved.  Caller holds one index lock;
+// an index being used right now was just written, or is about to be, so it
+// is never older than the cutoff.
+static void pruneOldIndexes(const std::string& dir) {
+  std::error_code ec;
+  fs::directory_iterator it(dir, ec);
+  if (ec) return;
+  const auto cutoff = fs::file_time_type::clock::now() - std::chrono::hours(24 * 30);
+  for (fs::directory_iterator end; it != end; it.increment(ec)) {
+    if (ec) break;
+    const fs::path& p = it->path();
+    bool isIndex = p.extension() == ".idx";
+    if (!isIndex && p.extension() != ".lock") continue;
+    std::error_code fileEc;
+    if (!it->is_regular_file(fileEc) || fileEc) continue;
+    auto lastWrite = it->last_write_time(fileEc);
+    if (fileEc || lastWrite >= cutoff) continue;
+    fs::path idx = p, lock = p;
+    idx.replace_extension(".idx");
+    lock.replace_extension(".lock");
+    if (!isIndex && fs::exists(idx, fileEc)) continue;  // its index decides
+    removeIndexUnlessLocked(idx, lock);
+  }
+}
+
+// --- index ---------------------------------------------------------------
+
+struct DedupIndex::RowSignature {
+  uint64_t lo, hi, blockKey;
+  std::vector<uint64_t> columns;
+};
+
+DedupIndex::DedupIndex(const std::string& name, const std::vector<std::string>& header,
+                       const std::vector<ColumnType>& columnTypes, const std::string& directory)
+    : directory_(directory), columnTypes_(columnTypes) {
+  if (!isValidIndexName(name)) throw std::invalid_argument("dedup index: invalid index name");
+  path_ = directory_ + "/" + name + ".idx";
+  headerHash_ = stableRowHash(header, 0x13198a2e03707344ULL);
+  columnTypes_.resize(header.size(), ColumnType::GENERIC_TEXT);
+
+  // advisory, like the backup lock: it serialises requests on this index,
+  // nothing more.  Pruning may unlink the lock file while we wait on it; the
+  // lock only counts if the path still names the file we locked.
+  std::string lockPath = directory_ + "/" + name + ".lock";
+  for (;;) {
+    lockFd_ = open(lockPath.c_str(), O_CREAT | O_RDWR, 0600);
+    if (lockFd_ == -1 || flock(lockFd_, LOCK_EX) == -1) {
+      if (lockFd_ != -1) close(lockFd_);
+      throw std::runtime_error("dedup index: cannot lock " + lockPath);
+    }
+    struct stat held, named;
+    if (fstat(lockFd_, &held) == 0 && stat(lockPath.c_str(), &named) == 0 &&
+        held.st_dev == named.st_dev && held.st_ino == named.st_ino)
+      break;
+    close(lockFd_);
+  }
+  try {
+    load();
+  } catch (...) {
+    close(lockFd_);
+    throw;
+  }
+}
+
+DedupIndex::~DedupIndex() {
+  if (lockFd_ != -1) close(lockFd_);  // releases the flock
+}
+
+void DedupIndex::load() {
+  std::ifstream in(path_, std::ios::binary);
+  if (!in) {
+    rebuildLookups();
+    return;  // new index
+  }
+  in.seekg(0, std::ios::end);
+  std::string bytes(static_cast<size_t>(in.tellg()), '\0');
+  in.seekg(0);
+  in.read(&bytes[0], static_cast<std::streamsize>(bytes.size()));
+  if (!in) throw std::runtime_error("dedup index: cannot read " + path_);
+  IndexReader r(bytes);
+  if (!std::equal(INDEX_MAGIC, INDEX_MAGIC + 8, r.take(8)) || r.u32() != INDEX_VERSION)
+    throw std::runtime_error("dedup index: not an index file: " + path_);
+  uint32_t columns = r.u32();
+  uint64_t storedHeader = r.u64();
+  uint64_t rows = r.u64();
+  if (storedHeader != headerHash_ || columns != columnTypes_.size())
+    throw std::invalid_argument("dedup index: upload columns differ from the indexed ones");
+  for (auto& t : columnTypes_) {
+    uint8_t v = r.u8();
+    if (v > static_cast<uint8_t>(ColumnType::GENERIC_TEXT))
+      throw std::runtime_error("dedup index: corrupt index file: " + path_);
+    t = static_cast<ColumnType>(v);
+  }
+  if (rows > r.remaining() / recordSize(columns))
+    throw std::runtime_error("dedup index: truncated index file");
+
+  rowHashLo_.resize(rows);
+  rowHashHi_.resize(rows);
+  blockKeys_.resize(rows);
+  columnHashes_.resize(rows * columns);
+  for (size_t e = 0; e < rows; e++) {
+    rowHashLo_[e] = r.u64();
+    rowHashHi_[e] = r.u64();
+    blockKeys_[e] = r.u64();
+    for (size_t c = 0; c < columns; c++) columnHashes_[e * columns + c] = r.u64();
+  }
+  onDisk_ = true;
+  savedRows_ = rows;
+  rebuildLookups();
+}
+
+void DedupIndex::save() {
+  const size_t columns = columnTypes_.size();
+  std::string records;
+  records.reserve((size() - savedRows_) * recordSize(columns));
+  for (size_t e = savedRows_; e < size(); e++) {
+    putU64(records, rowHashLo_[e]);
+    putU64(records, rowHashHi_[e]);
+    putU64(records, blockKeys_[e]);
+    for (size_t c = 0; c < columns; c++) putU64(records, columnHashes_[e * columns + c]);
+  }
+
+  if (onDisk_) {
+    // append past the last committed record (dropping any unfinished append),
+    // then commit by rewriting the row count; rewriting it also refreshes the
+    // file's retention time when nothing was added
+    std::string count;
+    putU64(count, size());
+    const std::streamoff end = recordsOffset(columns) + static_cast<std::streamoff>(size() * recordSize(columns));
+    {
+      std::fstream file(path_, std::ios::binary | std::ios::in | std::ios::out);
+      file.seekp(recordsOffset(columns) + static_cast<std::streamoff>(savedRows_ * recordSize(columns)));
+      file.write(records.data(), static_cast<std::streamsize>(records.size()));
+      file.flush();
+      file.seekp(ROW_COUNT_OFFSET);
+      file.write(count.data(), static_cast<std::streamsize>(count.size()));
+      file.close();
+      if (!file) throw std::runtime_error("dedup index: cannot write " + path_);
+    }
+    std::error_code ec;
+    if (fs::file_size(path_, ec) > static_cast<uintmax_t>(end)) fs::resize_file(path_, static_cast<uintmax_t>(end), ec);
+  } else {
+    std::string out;
+    out.reserve(static_cast<size_t>(recordsOffset(columns)) + records.size());
+    out.append(INDEX_MAGIC, 8);
+    putU32(out, INDEX_VERSION);
+    putU32(out, static_cast<uint32_t>(columns));
+    putU64(out, headerHash_);
+    putU64(out, size());
+    for (ColumnType t : columnTypes_) out += static_cast<char>(t);
+    out += records;
+
+    // a crash mid-write leaves no half-written index behind
+    std::string tmp = path_ + ".tmp";
+    {
+      std::ofstream os(tmp, std::ios::binary | std::ios::trunc);
+      os.write(out.data(), static_cast<std::streamsize>(out.size()));
+      os.close();
+      if (!os) throw std::runtime_error("dedup index: cannot write " + tmp);
+    }
+    fs::permissions(tmp, fs::perms::owner_read | fs::perms::owner_write, fs::perm_options::replace);
+    fs::rename(tmp, path_);
+    onDisk_ = true;
+  }
+  savedRows_ = size();
+  pruneOldIndexes(directory_);
+}
+
+DedupIndex::RowSignature DedupIndex::sign(const std::vector<std::string>& row) const {
+  RowSignature s;
+  s.lo = stableRowHash(row, 0x243f6a8885a308d3ULL);
+  s.hi = stableRowHash(row, 0xa4093822299f31d0ULL);
+  // the blocking key packs prefixes of cell text; only its hash is kept,
+  // which is all the equality lookups need
+  std::string key;
+  putU64(key, rowBlockingKey(row, columnTypes_));
+  s.blockKey = stableHash(key, 0xbe5466cf34e90c6cULL);
+  s.columns.resize(columnTypes_.size(), 0);
+  for (size_t c = 0; c < columnTypes_.size() && c < row.size(); c++)
+    s.columns[c] = columnHash(row[c], columnTypes_[c]);
+  return s;
+}
+
+// --- lookups -------------------------------------------------------------
+
+// Both tables are rebuilt in one linear pass, oldest entry first, so each
+// block chain runs newest to oldest -- the order filter() scans in.
+void DedupIndex::rebuildLookups() {
+  size_t cap = 16;
+  while (cap < size() * 2) cap <<= 1;
+  exactSlots_.assign(cap, UINT32_MAX);
+  blockSlots_.assign(cap, UINT32_MAX);
+  prevInBlock_.resize(size());
+  for (size_t e = 0; e < size(); e++) {
+    insertExact(static_cast<uint32_t>(e));
+    insertBlock(static_cast<uint32_t>(e));
+  }
+}
+
+void DedupIndex::insertExact(uint32_t entry) {
+  size_t mask = exactSlots_.size() - 1;
+  size_t s = rowHashLo_[entry] & mask;
+  while (exactSlots_[s] != UINT32_MAX) s = (s + 1) & mask;
+  exactSlots_[s] = entry;
+}
+
+bool DedupIndex::containsExact(uint64_t lo, uint64_t hi) const {
+  size_t mask = exactSlots_.size() - 1;
+  for (size_t s = lo & mask; exactSlots_[s] != UINT32_MAX; s = (s + 1) & mask) {
+    uint32_t e = exactSlots_[s];
+    if (rowHashLo_[e] == lo && rowHashHi_[e] == hi) return true;
+  }
+  return false;
+}
+
+// Stored block keys are already hashes, so their low bits index the table.
+void DedupIndex::insertBlock(uint32_t entry) {
+  size_t mask = blockSlots_.size() - 1;
+  size_t s = blockKeys_[entry] & mask;
+  while (blockSlots_[s] != UINT32_MAX && blockKeys_[blockSlots_[s]] != blockKeys_[entry]) s = (s + 1) & mask;
+  prevInBlock_[entry] = blockSlots_[s];
+  blockSlots_[s] = entry;
+}
+
+uint32_t DedupIndex::newestInBlock(uint64_t blockKey) const {
+  size_t mask = blockSlots_.size() - 1;
+  for (size_t s = blockKey & mask; blockSlots_[s] != UINT32_MAX; s = (s + 1) & mask)
+    if (blockKeys_[blockSlots_[s]] == blockKey) return blockSlots_[s];
+  return UINT32_MAX;
+}
+
+// --- filter / add --------------------------------------------------------
+
+IndexFilterResult DedupIndex::filter(const std::vector<std::vector<std::string>>& data,
+                                     double threshold) const {
+  IndexFilterResult result;
+  if (data.empty()) return result;
+  result.data.push_back(data[0]);
+  const size_t columns = columnTypes_.size();
+
+  for (size_t i = 1; i < data.size(); i++) {
+    RowSignature s = sign(data[i]);
+    if (containsExact(s.lo, s.hi)) {
+      result.exactMatches++;
+      continue;
+    }
+
+    // weighted column agreement with the most recent rows of the same block,
+    // scored like rowSimilarity: ID disagreement vetoes, empty cells get half
+    // credit
+    bool matched = false;
+    int budget = FUZZY_CANDIDATES;
+    for (uint32_t e = newestInBlock(s.blockKey); e != UINT32_MAX && budget > 0 && !matched;
+         e = prevInBlock_[e], budget--) {
+      const uint64_t* stored = &columnHashes_[static_cast<size_t>(e) * columns];
+      double weighted = 0.0, total = 0.0;
+      bool veto = false;
+      for (size_t c = 0; c < columns; c++) {
+        double w = typeWeight(columnTypes_[c]);
+        total += w;
+        if (s.columns[c] == 0 || stored[c] == 0) weighted += 0.5 * w;
+        else if (s.columns[c] == stored[c]) weighted += w;
+        else if (columnTypes_[c] == ColumnType::ID) { veto = true; break; }
+      }
+      matched = !veto && total > 0.0 && weighted / total >= threshold;
+    }
+    if (matched) {
+      result.fuzzyMatches++;
+      continue;
+    }
+    result.data.push_back(data[i]);
+  }
+  return result;
+}
+
+void DedupIndex::add(const std::vector<std::vector<std::string>>& data) {
+  const size_t columns = columnTypes_.size();
+  for (size_t i = 1; i < data.size(); i++) {
+    RowSignature s = sign(data[i]);
+    if (containsExact(s.lo, s.hi)) continue;
+    if (size() >= UINT32_MAX - 1) throw std::length_error("dedup index: too many rows");
+    rowHashLo_.push_back(s.lo);
+    rowHashHi_.push_back(s.hi);
+    blockKeys_.push_back(s.blockKey);
+    columnHashes_.insert(columnHashes_.end(), s.columns.begin(), s.columns.begin() + columns);
+    if (size() * 2 > exactSlots_.size()) {
+      rebuildLookups();
+    } else {
+      prevInBlock_.push_back(UINT32_MAX);
+      insertExact(static_cast<uint32_t>(size() - 1));
+      insertBlock(static_cast<uint32_t>(size() - 1));
+    }
+  }
+}
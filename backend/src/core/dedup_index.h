@@ -0,0 +1,110 @@
+#ifndef DEDUP_INDEX_H
+#define DEDUP_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "column_type_detection.h"
+
+// Persistent dedup index for incremental uploads.  A named index remembers
+// every row it has kept -- as hashes, never cell text -- so that the next
+// upload of an overlapping export only has to be checked against the index
+// and against itself, instead of re-running dedup over everything seen so
+// far.  Per row it stores a 128-bit hash of the whole row, a hash of the
+// row's blocking key and one hash per column of the cell's comparison form.
+//
+// Rows match the index exactly on the row hash, or fuzzily when a row with
+// the same blocking key agrees on enough weighted columns.  Column agreement
+// is all-or-nothing on the comparison form (case, token order and phone or
+// date formatting are normalised away, typos are not), so the fuzzy check is
+// stricter than weightedDeduplicate's per-type kernels: it can miss a
+// near-duplicate, never invent one.
+//
+// Index files use an explicit little-endian layout with their own hash, so
+// they stay valid across builds.  Records are fixed width and only ever
+// appended, so saving after an upload writes just the new rows.  Files live
+// in getDedupIndexDirectory() and follow the backups' 30-day retention: an
+// index not written for 30 days is removed along with its lock file.
+
+// TOOLKIT_DEDUP_INDEX_DIR if set, otherwise /tmp/toolkit_dedup_index; created
+// (0700) if missing.
+std::string getDedupIndexDirectory();
+
+// Index names are 1-64 characters of [A-Za-z0-9_-].
+bool isValidIndexName(const std::string& name);
+
+// Indexes reached over HTTP are keyed by a client-held secret rather than a
+// name anyone could guess: a token of 32-128 characters of [A-Za-z0-9_-],
+// stored only as the hex SHA-256 that names its index file.  Whoever holds
+// the token can read match counts from the index and add to it; nobody else
+// can find it.
+bool isValidIndexToken(const std::string& token);
+std::string indexNameForToken(const std::string& token);
+
+struct IndexFilterResult {
+  std::vector<std::vector<std::string>> data;  // header plus rows not in the index
+  int exactMatches = 0;
+  int fuzzyMatches = 0;
+};
+
+class DedupIndex {
+public:
+  // Opens the named index, creating it for `header` and `columnTypes` if it
+  // does not exist yet, and holds its lock until destroyed: concurrent
+  // requests on one index are serialised, different indexes do not contend.
+  // An existing index keeps the column types it was created with.
+  //
+  // Throws std::invalid_argument for a bad name or a header that differs
+  // from the one the index was built for, std::runtime_error on I/O failure
+  // or a corrupt index file.
+  DedupIndex(const std::string& name, const std::vector<std::string>& header,
+             const std::vector<ColumnType>& columnTypes,
+             const std::string& directory = getDedupIndexDirectory());
+  ~DedupIndex();
+  DedupIndex(const DedupIndex&) = delete;
+  DedupIndex& operator=(const DedupIndex&) = delete;
+
+  // `data` (header first) without the rows already in the index.
+  IndexFilterResult filter(const std::vector<std::vector<std::string>>& data,
+                           double threshold) const;
+
+  // Adds the data rows of `data` (header skipped); rows already present are
+  // not added twice.
+  void add(const std::vector<std::vector<std::string>>& data);
+
+  // Appends the rows added since the index was opened and then updates the
+  // stored row count, so a crash part-way leaves the previous index intact.
+  // A new index is written to a temporary file and renamed into place.
+  void save();
+
+  size_t size() const { return blockKeys_.size(); }
+  const std::vector<ColumnType>& columnTypes() const { return columnTypes_; }
+
+private:
+  struct RowSignature;
+  RowSignature sign(const std::vector<std::string>& row) const;
+  void load();
+
+  std::string directory_;
+  std::string path_;
+  int lockFd_ = -1;
+  uint64_t headerHash_ = 0;
+  std::vector<ColumnType> columnTypes_;
+
+  // one entry per indexed row; columnHashes_ holds columnTypes_.size() per row
+  std::vector<uint64_t> rowHashLo_, rowHashHi_, blockKeys_, columnHashes_;
+  std::vector<uint32_t> exactSlots_;   // open addressing over rowHashLo_
+  std::vector<uint32_t> blockSlots_;   // open addressing: newest entry per block key
+  std::vector<uint32_t> prevInBlock_;  // per entry: next older entry with its block key
+  bool onDisk_ = false;                // the index file exists
+  size_t savedRows_ = 0;               // rows the index file holds
+
+  void insertExact(uint32_t entry);
+  bool containsExact(uint64_t lo, uint64_t hi) const;
+  void insertBlock(uint32_t entry);
+  uint32_t newestInBlock(uint64_t blockKey) const;
+  void rebuildLookups();
+};
+
+#endif
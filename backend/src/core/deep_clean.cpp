@@ -5,6 +5,7 @@
 #include "string_issue_detectors.h"
 #include "text_normalisation.h"
 #include "cluster_detection.h"
+#include "char_class.h"
 
 #include <algorithm>
 
@@ -38,9 +39,10 @@ static std::string transformCell(const std::string& cell, ColumnType type) {
     case ColumnType::PHONE:
       {
         std::string out;
+        out.reserve(cell.size());
         for (char c : cell) {
           if (c == '+' && out.empty()) out += c;
-          else if (c >= '0' && c <= '9') out += c;
+          else if (charClass(c) & CC_DIGIT) out += c;
         }
         // fall back to original if stripping removes everything
         return out.empty() ? cell : out;
@@ -214,6 +216,12 @@ static std::vector<std::vector<std::string>> autoMergeColumns(
 // --- main pipeline ------------------------------------------------------
 
 DeepCleanResult deepClean(const std::vector<std::vector<std::string>>& parsed) {
+  DeepCleanResult result = deepCleanExact(parsed);
+  deepCleanFuzzy(result);
+  return result;
+}
+
+DeepCleanResult deepCleanExact(const std::vector<std::vector<std::string>>& parsed) {
   DeepCleanResult result;
   if (parsed.empty()) return result;
 
@@ -237,8 +245,9 @@ DeepCleanResult deepClean(const std::vector<std::vector<std::string>>& parsed) {
   result.auditLog.addEntry("Standardise Null Values", countChangedCells(tidied, nulled),
                            (int)tidied.size(), (int)nulled.size(), "nulls");
 
-  // Phase 3: Detect column types
-  auto typeResult = detectColumnTypes(nulled);
+  // Phase 3: Detect column types — over whole columns, so a format change
+  // after the first few hundred rows cannot mistype the column
+  auto typeResult = detectColumnTypesFull(nulled);
   result.columnTypes = typeResult.types;
   result.columnNames = typeResult.names;
   {
@@ -258,17 +267,23 @@ DeepCleanResult deepClean(const std::vector<std::vector<std::string>>& parsed) {
   auto merged = autoMergeColumns(transformed, result.columnTypes, result.columnNames, result.auditLog);
 
   // Phase 6: Exact dedup
-  auto exactDeduped = removeDuplicates(merged);
-  int exactRemoved = (int)merged.size() - (int)exactDeduped.size();
-  result.auditLog.addEntry("Exact Deduplication", exactRemoved, (int)merged.size(), (int)exactDeduped.size(),
+  int mergedRows = (int)merged.size();
+  auto exactDeduped = removeDuplicates(std::move(merged));
+  int exactRemoved = mergedRows - (int)exactDeduped.size();
+  result.auditLog.addEntry("Exact Deduplication", exactRemoved, mergedRows, (int)exactDeduped.size(),
                            "dedup-pass-1-exact");
 
+  result.cleanedData = std::move(exactDeduped);
+  return result;
+}
+
+void deepCleanFuzzy(DeepCleanResult& result) {
+  if (result.cleanedData.empty()) return;
+
   // Phase 7: Weighted fuzzy dedup
-  auto fuzzyDeduped = weightedDeduplicate(exactDeduped, result.columnTypes, 0.95);
+  auto fuzzyDeduped = weightedDeduplicate(result.cleanedData, result.columnTypes, 0.95);
   result.auditLog.addEntry("Weighted Fuzzy Deduplication", 0,
-                           (int)exactDeduped.size(), (int)fuzzyDeduped.data.size(),
+                           (int)result.cleanedData.size(), (int)fuzzyDeduped.data.size(),
                            "dedup-pass-1-fuzzy");
-
-  result.cleanedData = fuzzyDeduped.data;
-  return result;
+  result.cleanedData = std::move(fuzzyDeduped.data);
 }
@@ -15,4 +15,12 @@ struct DeepCleanResult {
 
 DeepCleanResult deepClean(const std::vector<std::vector<std::string>>& parsed);
 
+// deepClean in two steps, for callers that drop rows between the exact and
+// the fuzzy dedup (e.g. rows a persistent dedup index already holds), so the
+// fuzzy pass only compares what is left.  deepCleanExact runs phases 1-6 and
+// leaves the exact-deduplicated rows in cleanedData; deepCleanFuzzy runs the
+// weighted fuzzy dedup over cleanedData in place.
+DeepCleanResult deepCleanExact(const std::vector<std::vector<std::string>>& parsed);
+void deepCleanFuzzy(DeepCleanResult& result);
+
 #endif
@@ -0,0 +1,263 @@
+#include "external_dedup.h"
+#include "csv_parser.h"
+#include "csv_serializer.h"
+#include "row_hash.h"
+#include "spill_file.h"
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static const unsigned SPLIT_BITS = 4;              // fan-out 16 when a partition is split again
+static const size_t OUTPUT_FLUSH_BYTES = 1 << 20;
+
+// --- spill record format -------------------------------------------------
+
+// [u64 sequence][u32 cell count] then per cell [u32 length][bytes], in host
+// byte order: spill files never outlive the process that wrote them.
+
+static void writeRecord(std::ostream& os, uint64_t seq, const std::vector<std::string>& row) {
+  uint32_t cells = static_cast<uint32_t>(row.size());
+  os.write(reinterpret_cast<const char*>(&seq), sizeof(seq));
+  os.write(reinterpret_cast<const char*>(&cells), sizeof(cells));
+  for (const auto& cell : row) {
+    uint32_t len = static_cast<uint32_t>(cell.size());
+    os.write(reinterpret_cast<const char*>(&len), sizeof(len));
+    os.write(cell.data(), static_cast<std::streamsize>(cell.size()));
+  }
+}
+
+static bool readRecord(std::istream& is, uint64_t& seq, std::vector<std::string>& row) {
+  uint32_t cells = 0;
+  if (!is.read(reinterpret_cast<char*>(&seq), sizeof(seq))) return false;
+  if (!is.read(reinterpret_cast<char*>(&cells), sizeof(cells)))
+    throw std::runtime_error("external dedup: truncated spill file");
+  row.resize(cells);
+  for (auto& cell : row) {
+    uint32_t len = 0;
+    if (!is.read(reinterpret_cast<char*>(&len), sizeof(len)))
+      throw std::runtime_error("external dedup: truncated spill file");
+    cell.resize(len);
+    if (len > 0 && !is.read(&cell[0], len))
+      throw std::runtime_error("external dedup: truncated spill file");
+  }
+  return true;
+}
+
+// Approximate heap cost of holding a row in the partition table, used to
+// keep each partition within the memory budget.
+static size_t rowFootprint(const std::vector<std::string>& row) {
+  size_t bytes = sizeof(row) + sizeof(uint64_t) * 2 + sizeof(uint32_t) * 2;
+  for (const auto& cell : row) bytes += sizeof(cell) + (cell.size() > 15 ? cell.size() + 1 : 0);
+  return bytes;
+}
+
+// Partition number of a row hash, taking `bits` bits after the top `usedBits`.
+static size_t partitionOf(uint64_t hash, unsigned usedBits, unsigned bits) {
+  return static_cast<size_t>((hash << usedBits) >> (64 - bits));
+}
+
+// --- partition pass ------------------------------------------------------
+
+struct DedupRun {
+  const ExternalDedupOptions& options;
+  SpillDirectory& dir;
+  ExternalDedupStats& stats;
+  std::vector<std::string> survivorFiles;
+
+  // Split one spill file into 2^bits files on the hash bits after usedBits.
+  std::vector<std::string> split(const std::string& path, unsigned usedBits, unsigned bits) {
+    size_t parts = size_t(1) << bits;
+    std::vector<std::string> paths(parts);
+    std::vector<std::unique_ptr<std::ofstream>> outs(parts);
+    for (size_t p = 0; p < parts; p++) {
+      paths[p] = dir.newFile("part-");
+      outs[p] = openSpill(paths[p]);
+    }
+    std::ifstream in(path, std::ios::binary);
+    uint64_t seq;
+    std::vector<std::string> row;
+    while (readRecord(in, seq, row))
+      writeRecord(*outs[partitionOf(hashRow(row), usedBits, bits)], seq, row);
+    for (size_t p = 0; p < parts; p++) closeSpill(*outs[p], paths[p]);
+    return paths;
+  }
+
+  // Deduplicate one partition into a survivor file, or split it further if
+  // its distinct rows exceed the memory budget.
+  void process(const std::string& path, unsigned usedBits) {
+    bool canSplit = usedBits + SPLIT_BITS <= 64;
+    std::vector<std::vector<std::string>> rows;
+    std::vector<uint64_t> hashes;
+    std::vector<uint64_t> seqs;
+    RowIndexTable seen(hashes);
+    auto sameRow = [&](size_t a, size_t b) { return rows[a] == rows[b]; };
+    size_t bytes = 0;
+    bool overflow = false;
+    {
+      std::ifstream in(path, std::ios::binary);
+      if (!in) throw std::runtime_error("external dedup: cannot read spill file " + path);
+      uint64_t seq;
+      std::vector<std::string> row;
+      while (readRecord(in, seq, row)) {
+        hashes.push_back(hashRow(row));
+        rows.push_back(std::move(row));
+        size_t idx = rows.size() - 1;
+        if (seen.findOrInsert(idx, sameRow) != idx) {
+          rows.pop_back();
+          hashes.pop_back();
+          continue;
+        }
+        seqs.push_back(seq);
+        bytes += rowFootprint(rows.back());
+        if (bytes > options.memoryBudgetBytes && canSplit) {
+          overflow = true;
+          break;
+        }
+      }
+    }
+
+    if (overflow) {
+      rows.clear();
+      rows.shrink_to_fit();
+      stats.repartitions++;
+      auto parts = split(path, usedBits, SPLIT_BITS);
+      fs::remove(path);
+      for (const auto& part : parts) process(part, usedBits + SPLIT_BITS);
+      return;
+    }
+
+    fs::remove(path);
+    if (rows.empty()) return;  // nothing to merge: no file, no descriptor later
+    // rows arrive in sequence order, so the survivor file is already sorted
+    std::string out = dir.newFile("kept-");
+    auto os = openSpill(out);
+    for (size_t i = 0; i < rows.size(); i++) writeRecord(*os, seqs[i], rows[i]);
+    closeSpill(*os, out);
+    survivorFiles.push_back(out);
+    stats.rowsKept += rows.size();
+  }
+};
+
+static unsigned partitionBits(const ExternalDedupOptions& options) {
+  size_t parts = options.partitions;
+  if (parts == 0) {
+    // enough partitions for each to fit the budget twice over, within [16, 256]
+    size_t budget = options.memoryBudgetBytes ? options.memoryBudgetBytes : 1;
+    parts = options.inputSizeHint ? options.inputSizeHint / budget * 2 : 64;
+    parts = std::min<size_t>(std::max<size_t>(parts, 16), 256);
+  }
+  unsigned bits = 1;
+  while ((size_t(1) << bits) < parts && bits < 16) bits++;
+  return bits;
+}
+
+// --- merge by sequence number --------------------------------------------
+
+// Merges survivor files by sequence number, calling emit(seq, row) in order.
+template <typename Emit>
+static void mergeBySequence(const std::vector<std::string>& files, Emit&& emit) {
+  struct Cursor {
+    std::ifstream in;
+    uint64_t seq = 0;
+    std::vector<std::string> row;
+  };
+  std::vector<std::unique_ptr<Cursor>> cursors;
+  using Head = std::pair<uint64_t, size_t>;  // (sequence, cursor)
+  std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heap;
+  for (const auto& file : files) {
+    auto c = std::make_unique<Cursor>();
+    c->in.open(file, std::ios::binary);
+    if (!c->in) throw std::runtime_error("external dedup: cannot read spill file " + file);
+    if (readRecord(c->in, c->seq, c->row)) heap.push({c->seq, cursors.size()});
+    cursors.push_back(std::move(c));
+  }
+  while (!heap.empty()) {
+    size_t idx = heap.top().second;
+    heap.pop();
+    Cursor& c = *cursors[idx];
+    emit(c.seq, c.row);
+    if (readRecord(c.in, c.seq, c.row)) heap.push({c.seq, idx});
+  }
+}
+
+// Sequence numbers are global, so any grouping of the files merges back into
+// input order: groups of MAX_MERGE_FAN_IN are merged into intermediate files
+// until one final merge writes the CSV.
+static void mergeSurvivors(std::vector<std::string> files, SpillDirectory& dir, std::ostream& out,
+                           ExternalDedupStats& stats) {
+  while (files.size() > MAX_MERGE_FAN_IN) {
+    std::vector<std::string> next;
+    for (size_t g = 0; g < files.size(); g += MAX_MERGE_FAN_IN) {
+      std::vector<std::string> group(files.begin() + g,
+                                     files.begin() + std::min(files.size(), g + MAX_MERGE_FAN_IN));
+      std::string path = dir.newFile("kept-");
+      auto os = openSpill(path);
+      mergeBySequence(group, [&](uint64_t seq, const std::vector<std::string>& row) {
+        writeRecord(*os, seq, row);
+      });
+      closeSpill(*os, path);
+      for (const auto& f : group) fs::remove(f);
+      next.push_back(path);
+    }
+    files.swap(next);
+    stats.mergePasses++;
+  }
+
+  std::string buffer;
+  mergeBySequence(files, [&](uint64_t, const std::vector<std::string>& row) {
+    appendCSVRow(buffer, row);
+    if (buffer.size() >= OUTPUT_FLUSH_BYTES) {
+      out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+      buffer.clear();
+    }
+  });
+  out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+  if (!files.empty()) stats.mergePasses++;
+}
+
+// --- entry point ---------------------------------------------------------
+
+ExternalDedupStats externalDeduplicate(std::istream& in, std::ostream& out,
+                                       const ExternalDedupOptions& options) {
+  ExternalDedupStats stats;
+  CsvRecordReader reader(in);
+  std::vector<std::string> row;
+  if (!reader.next(row)) return stats;
+
+  // header row is always kept and never compared
+  std::string header;
+  appendCSVRow(header, row);
+  out.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+  SpillDirectory dir(options.tempDir, "toolkit-dedup");
+  DedupRun run{options, dir, stats, {}};
+
+  unsigned bits = partitionBits(options);
+  size_t parts = size_t(1) << bits;
+  stats.partitions = parts;
+  std::vector<std::string> paths(parts);
+  std::vector<std::unique_ptr<std::ofstream>> spills(parts);
+  for (size_t p = 0; p < parts; p++) {
+    paths[p] = dir.newFile("part-");
+    spills[p] = openSpill(paths[p]);
+  }
+  uint64_t seq = 0;
+  while (reader.next(row)) {
+    writeRecord(*spills[partitionOf(hashRow(row), 0, bits)], seq++, row);
+  }
+  stats.rowsRead = seq;
+  for (size_t p = 0; p < parts; p++) closeSpill(*spills[p], paths[p]);
+  spills.clear();
+
+  for (const auto& path : paths) run.process(path, bits);
+  mergeSurvivors(std::move(run.survivorFiles), dir, out, stats);
+  if (!out) throw std::runtime_error("external dedup: cannot write output");
+  return stats;
+}
@@ -0,0 +1,40 @@
+#ifndef EXTERNAL_DEDUP_H
+#define EXTERNAL_DEDUP_H
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+
+// Exact deduplication for CSV exports larger than memory.  Rows are streamed
+// through the row hasher and spilled into on-disk partitions by hash; each
+// partition is deduplicated on its own within the memory budget (partitions
+// whose distinct rows still do not fit are split again on further hash bits),
+// and the surviving rows are merged back by input sequence number, at most
+// MAX_MERGE_FAN_IN files at a time (spill_file.h).  The
+// output is what serializeToCSV(removeDuplicates(parseCSV(input))) would
+// produce, without ever holding the whole file.
+//
+// Spill files live in a private (0700) directory under tempDir and are
+// removed when the run ends, including on error.
+
+struct ExternalDedupOptions {
+  size_t memoryBudgetBytes = size_t(256) << 20;  // distinct rows held per partition
+  size_t partitions = 0;                         // 0 = derive from inputSizeHint
+  size_t inputSizeHint = 0;                      // bytes, if known (e.g. file size)
+  std::string tempDir;                           // empty = system temp directory
+};
+
+struct ExternalDedupStats {
+  size_t rowsRead = 0;       // data rows, excluding the header
+  size_t rowsKept = 0;       // distinct data rows, excluding the header
+  size_t partitions = 0;     // first-level partitions
+  size_t repartitions = 0;   // partitions that had to be split again
+  size_t mergePasses = 0;    // passes over the survivor files (0 when none)
+};
+
+// Throws std::runtime_error on I/O failure.
+ExternalDedupStats externalDeduplicate(std::istream& in, std::ostream& out,
+                                       const ExternalDedupOptions& options = {});
+
+#endif
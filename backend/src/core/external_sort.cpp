@@ -0,0 +1,251 @@
+#include "external_sort.h"
+#include "csv_parser.h"
+#include "csv_serializer.h"
+#include "spill_file.h"
+#include "structural_cleaners.h"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+static const size_t OUTPUT_FLUSH_BYTES = 1 << 20;
+
+// --- spill record format -------------------------------------------------
+
+// [u32 key length][key][u32 cell count] then per cell [u32 length][bytes], in
+// host byte order: spill files never outlive the process that wrote them.
+
+static void writeU32(std::ostream& os, size_t v) {
+  uint32_t x = static_cast<uint32_t>(v);
+  os.write(reinterpret_cast<const char*>(&x), sizeof(x));
+}
+
+static void writeRecord(std::ostream& os, const std::string& key, const std::vector<std::string>& row) {
+  writeU32(os, key.size());
+  os.write(key.data(), static_cast<std::streamsize>(key.size()));
+  writeU32(os, row.size());
+  for (const auto& cell : row) {
+    writeU32(os, cell.size());
+    os.write(cell.data(), static_cast<std::streamsize>(cell.size()));
+  }
+}
+
+static void readBytes(std::istream& is, std::string& s) {
+  uint32_t len = 0;
+  if (!is.read(reinterpret_cast<char*>(&len), sizeof(len)))
+    throw std::runtime_error("external sort: truncated spill file");
+  s.resize(len);
+  if (len > 0 && !is.read(&s[0], len)) throw std::runtime_error("external sort: truncated spill file");
+}
+
+static bool readRecord(std::istream& is, std::string& key, std::vector<std::string>& row) {
+  if (is.peek() == std::char_traits<char>::eof()) return false;
+  readBytes(is, key);
+  uint32_t cells = 0;
+  if (!is.read(reinterpret_cast<char*>(&cells), sizeof(cells)))
+    throw std::runtime_error("external sort: truncated spill file");
+  row.resize(cells);
+  for (auto& cell : row) readBytes(is, cell);
+  return true;
+}
+
+// Approximate heap cost of holding a row (and its sort key) in a run.
+static size_t rowFootprint(const std::vector<std::string>& row, size_t column) {
+  size_t bytes = sizeof(row) + sizeof(uint32_t) + sizeof(size_t);
+  for (const auto& cell : row) bytes += sizeof(cell) + (cell.size() > 15 ? cell.size() + 1 : 0);
+  if (column < row.size()) bytes += row[column].size() + 8;
+  return bytes;
+}
+
+// --- output --------------------------------------------------------------
+
+namespace {
+// Rows go either to a CSV stream (buffered) or to another run file.
+class RowSink {
+public:
+  explicit RowSink(std::ostream& csv) : csv_(&csv) {}
+  explicit RowSink(std::ofstream& run) : run_(&run) {}
+  ~RowSink() { flush(); }
+
+  void add(const std::string& key, const std::vector<std::string>& row) {
+    if (run_) { writeRecord(*run_, key, row); return; }
+    appendCSVRow(buffer_, row);
+    if (buffer_.size() >= OUTPUT_FLUSH_BYTES) flush();
+  }
+  void flush() {
+    if (!csv_ || buffer_.empty()) return;
+    csv_->write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+  }
+
+private:
+  std::ostream* csv_ = nullptr;
+  std::ofstream* run_ = nullptr;
+  std::string buffer_;
+};
+
+struct RunCursor {
+  std::ifstream in;
+  std::string key;
+  std::vector<std::string> row;
+  bool done = false;
+  void advance() { done = !readRecord(in, key, row); }
+};
+
+// Tournament of losers over k cursors: tree_[0] holds the current winner and
+// tree_[1..k-1] the loser of each internal match, with the leaves at k..2k-1
+// implicit.  Advancing the winner replays only its path to the root, about
+// log2(k) key comparisons per row instead of a heap's 2*log2(k).  Ties go to
+// the lower cursor, so rows with equal keys keep the order of their runs.
+class LoserTree {
+public:
+  explicit LoserTree(std::vector<std::unique_ptr<RunCursor>>& cursors)
+      : cursors_(cursors), k_(cursors.size()), tree_(std::max<size_t>(k_, 1)) {
+    std::vector<size_t> winner(2 * k_);
+    for (size_t i = 0; i < k_; i++) winner[k_ + i] = i;
+    for (size_t n = k_; n-- > 1;) {
+      size_t a = winner[2 * n], b = winner[2 * n + 1];
+      if (before(a, b)) { winner[n] = a; tree_[n] = b; }
+      else { winner[n] = b; tree_[n] = a; }
+    }
+    tree_[0] = k_ > 1 ? winner[1] : 0;
+  }
+
+  bool empty() const { return k_ == 0 || cursors_[tree_[0]]->done; }
+  RunCursor& top() { return *cursors_[tree_[0]]; }
+
+  void pop() {
+    size_t w = tree_[0];
+    cursors_[w]->advance();
+    for (size_t n = (k_ + w) / 2; n >= 1; n /= 2)
+      if (before(tree_[n], w)) std::swap(tree_[n], w);
+    tree_[0] = w;
+  }
+
+private:
+  bool before(size_t a, size_t b) const {
+    const RunCursor& x = *cursors_[a];
+    const RunCursor& y = *cursors_[b];
+    if (x.done || y.done) return !x.done;
+    int c = x.key.compare(y.key);
+    return c < 0 || (c == 0 && a < b);
+  }
+
+  std::vector<std::unique_ptr<RunCursor>>& cursors_;
+  size_t k_;
+  std::vector<size_t> tree_;
+};
+}
+
+static void mergeRuns(const std::vector<std::string>& files, RowSink& sink) {
+  std::vector<std::unique_ptr<RunCursor>> cursors;
+  for (const auto& file : files) {
+    auto c = std::make_unique<RunCursor>();
+    c->in.open(file, std::ios::binary);
+    if (!c->in) throw std::runtime_error("external sort: cannot read spill file " + file);
+    c->advance();
+    cursors.push_back(std::move(c));
+  }
+  LoserTree tree(cursors);
+  while (!tree.empty()) {
+    sink.add(tree.top().key, tree.top().row);
+    tree.pop();
+  }
+}
+
+// --- entry points --------------------------------------------------------
+
+ExternalSortStats externalNaturalSort(CsvRecordReader& reader, std::ostream& out, int column,
+                                      const ExternalSortOptions& options) {
+  ExternalSortStats stats;
+  std::vector<std::vector<std::string>> run(1);
+  if (!reader.next(run[0])) return stats;
+  RowSink csv(out);
+  csv.add(std::string(), run[0]);
+
+  std::vector<std::string> row;
+  if (column < 0 || column >= static_cast<int>(run[0].size())) {
+    while (reader.next(row)) {
+      csv.add(std::string(), row);
+      stats.rowsRead++;
+    }
+    csv.flush();
+    if (!out) throw std::runtime_error("external sort: cannot write output");
+    return stats;
+  }
+
+  // the run buffer keeps the header in slot 0, so it has the shape
+  // naturalSortOrder expects
+  const size_t col = static_cast<size_t>(column);
+  std::unique_ptr<SpillDirectory> dir;
+  std::vector<std::string> runFiles;
+  std::string key;
+  auto spill = [&]() {
+    if (!dir) dir = std::make_unique<SpillDirectory>(options.tempDir, "toolkit-sort");
+    std::string path = dir->newFile("run-");
+    auto os = openSpill(path);
+    for (uint32_t r : naturalSortOrder(run, column, options.threadCount)) {
+      key.clear();
+      if (col < run[r].size()) appendNaturalSortKey(run[r][col], key);
+      writeRecord(*os, key, run[r]);
+    }
+    closeSpill(*os, path);
+    runFiles.push_back(path);
+    run.resize(1);
+  };
+
+  size_t bytes = 0;
+  bool more = true;
+  while (more) {
+    more = reader.next(row);
+    if (more) {
+      bytes += rowFootprint(row, col);
+      run.push_back(std::move(row));
+      stats.rowsRead++;
+    }
+    if (bytes > options.memoryBudgetBytes || (!more && !runFiles.empty() && run.size() > 1)) {
+      spill();
+      bytes = 0;
+    }
+  }
+
+  if (runFiles.empty()) {
+    for (uint32_t r : naturalSortOrder(run, column, options.threadCount)) csv.add(key, run[r]);
+  } else {
+    run.clear();
+    run.shrink_to_fit();
+    stats.runs = runFiles.size();
+    // consecutive groups keep runs in input order, so ties stay stable
+    while (runFiles.size() > MAX_MERGE_FAN_IN) {
+      std::vector<std::string> next;
+      for (size_t g = 0; g < runFiles.size(); g += MAX_MERGE_FAN_IN) {
+        std::vector<std::string> group(runFiles.begin() + g,
+                                       runFiles.begin() + std::min(runFiles.size(), g + MAX_MERGE_FAN_IN));
+        std::string path = dir->newFile("run-");
+        auto os = openSpill(path);
+        {
+          RowSink sink(*os);
+          mergeRuns(group, sink);
+        }
+        closeSpill(*os, path);
+        for (const auto& f : group) std::filesystem::remove(f);
+        next.push_back(path);
+      }
+      runFiles.swap(next);
+      stats.mergePasses++;
+    }
+    mergeRuns(runFiles, csv);
+    stats.mergePasses++;
+  }
+  csv.flush();
+  if (!out) throw std::runtime_error("external sort: cannot write output");
+  return stats;
+}
+
+ExternalSortStats externalNaturalSort(std::istream& in, std::ostream& out, int column,
+                                      const ExternalSortOptions& options) {
+  CsvRecordReader reader(in);
+  return externalNaturalSort(reader, out, column, options);
+}
@@ -0,0 +1,44 @@
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include "spill_file.h"
+
+class CsvRecordReader;
+
+// Natural sort (the naturalSortKey order of one column) for CSV exports
+// larger than memory.  Rows are read into a run until the memory budget is
+// reached; each run is sorted on its precomputed keys and spilled in a
+// binary row format that keeps the key, so merging never re-derives it.
+// Runs are then merged k-way through a loser tree (several passes when there
+// are more runs than MAX_MERGE_FAN_IN) and written out as CSV while they
+// stream.  The output is what serializeToCSV(naturalSort(parseCSV(input),
+// column)) would produce: header first, ties in input order.  Input that
+// fits in one run is sorted in memory without touching disk.
+//
+// Spill files live in a private (0700) directory under tempDir and are
+// removed when the run ends, including on error.
+
+struct ExternalSortOptions {
+  size_t memoryBudgetBytes = size_t(256) << 20;  // rows held per run
+  std::string tempDir;                           // empty = system temp directory
+  unsigned int threadCount = 0;                  // for sorting each run
+};
+
+struct ExternalSortStats {
+  size_t rowsRead = 0;     // data rows, excluding the header
+  size_t runs = 0;         // sorted runs written (0 when sorted in memory)
+  size_t mergePasses = 0;  // 1 for a single k-way merge
+};
+
+// An out-of-range column copies the input through unchanged.  Throws
+// std::runtime_error on I/O failure.
+ExternalSortStats externalNaturalSort(CsvRecordReader& reader, std::ostream& out, int column,
+                                      const ExternalSortOptions& options = {});
+ExternalSortStats externalNaturalSort(std::istream& in, std::ostream& out, int column,
+                                      const ExternalSortOptions& options = {});
+
+#endif
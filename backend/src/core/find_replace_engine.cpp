@@ -1,8 +1,14 @@
 #include "find_replace_rules.h"
+#include <algorithm>
 #include <regex>
 #include <future>
 #include <chrono>
 #include <iostream>
+#include <unordered_map>
+#include <cctype>
+#include <cstdint>
+#include <memory>
+#include "parallel_for.h"
 
 extern std::string applySubstringReplace(const std::string& cell,
   const FindReplaceRule& rule);
@@ -41,27 +47,146 @@ static std::string runRegexReplaceWithTimeout(
   return cell;
 }
 
-static std::string applyReplacement(const std::string& cell,
-  const FindReplaceRule& rule) {
-  if(rule.matchType == "exact") return matchesRule(cell, rule) ? rule.replace : cell;
-  if(rule.matchType == "substring") return applySubstringReplace(cell, rule);
-  if(rule.matchType == "regex") {
-    if(isRegexDangerous(rule.find)) {
-      std::cerr << "Warning: rejected dangerous regex pattern" << std::endl;
-      return cell;
+// --- rule plan --------------------------------------------------------------
+
+// Each run of consecutive "exact" rules is folded into one hash index keyed
+// by the find string (lower-cased for case-insensitive rules), so a cell
+// costs one lookup however many exact rules there are.  Rules still apply in
+// list order: after a hit only later rules of the same run are eligible,
+// which resolves chains like A->B, B->C exactly as the rule-by-rule loop did.
+struct ExactRuleIndex {
+  std::vector<const FindReplaceRule*> rules;
+  std::unordered_map<std::string, std::vector<size_t>> caseSensitive;
+  std::unordered_map<std::string, std::vector<size_t>> caseInsensitive;
+};
+
+// One step of the compiled plan.  Regex rules are vetted and compiled once
+// here rather than per cell; the plan is read-only while rows are processed,
+// so worker threads can share it.
+struct RuleStep {
+  const FindReplaceRule* rule = nullptr;  // set for substring/regex rules
+  std::shared_ptr<const std::regex> regex;
+  ExactRuleIndex exact;                   // used when rule is null
+};
+
+static void lowerInto(const std::string& s, std::string& out) {
+  out.resize(s.size());
+  for(size_t i = 0; i < s.size(); i++)
+    out[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(s[i])));
+}
+
+static std::vector<RuleStep> buildRulePlan(const std::vector<FindReplaceRule>& rules) {
+  std::vector<RuleStep> plan;
+  std::string lowered;
+  for(const auto& rule : rules) {
+    if(rule.matchType != "exact") {
+      RuleStep step;
+      step.rule = &rule;
+      if(rule.matchType == "regex") {
+        if(isRegexDangerous(rule.find)) {
+          std::cerr << "Warning: rejected dangerous regex pattern" << std::endl;
+        } else {
+          try {
+            step.regex = std::make_shared<const std::regex>(rule.find,
+              rule.caseSensitive ? std::regex::ECMAScript :
+              (std::regex::ECMAScript | std::regex::icase));
+          } catch(...) {}
+        }
+      }
+      plan.push_back(std::move(step));
+      continue;
+    }
+    if(plan.empty() || plan.back().rule) plan.emplace_back();
+    ExactRuleIndex& idx = plan.back().exact;
+    size_t local = idx.rules.size();
+    idx.rules.push_back(&rule);
+    if(rule.caseSensitive) {
+      idx.caseSensitive[rule.find].push_back(local);
+    } else {
+      lowerInto(rule.find, lowered);
+      idx.caseInsensitive[lowered].push_back(local);
     }
-    try {
-      std::regex re(rule.find, rule.caseSensitive ? std::regex::ECMAScript :
-        (std::regex::ECMAScript | std::regex::icase));
-      return runRegexReplaceWithTimeout(cell, re, rule.replace);
-    } catch(...) { return cell; }
   }
-  return cell;
+  return plan;
 }
 
-FindReplaceResult applyFindReplace(const std::vector<std::vector<std::string>>& data,
+// --- applying the plan -------------------------------------------------------
+
+// Replace cell with value, moving the pre-rule value into `original` the first
+// time the cell changes so untouched cells are never copied.
+static void assignCell(std::string& cell, std::string&& value, std::string& original,
+  bool& touched) {
+  if(value == cell) return;
+  if(!touched) { original = std::move(cell); touched = true; }
+  cell = std::move(value);
+}
+
+// first rule index >= from in a hit list (lists are built in ascending order)
+static size_t firstEligible(const std::unordered_map<std::string, std::vector<size_t>>& map,
+  const std::string& key, size_t from) {
+  auto it = map.find(key);
+  if(it == map.end()) return SIZE_MAX;
+  auto pos = std::lower_bound(it->second.begin(), it->second.end(), from);
+  return pos == it->second.end() ? SIZE_MAX : *pos;
+}
+
+static void applyExactIndex(std::string& cell, const ExactRuleIndex& idx,
+  std::string& scratch, std::string& original, bool& touched) {
+  size_t from = 0;
+  while(from < idx.rules.size()) {
+    size_t hit = firstEligible(idx.caseSensitive, cell, from);
+    if(!idx.caseInsensitive.empty()) {
+      lowerInto(cell, scratch);
+      hit = std::min(hit, firstEligible(idx.caseInsensitive, scratch, from));
+    }
+    if(hit == SIZE_MAX) return;
+    assignCell(cell, std::string(idx.rules[hit]->replace), original, touched);
+    from = hit + 1;
+  }
+}
+
+// Runs every step on the cell in place.  Returns true when the final value
+// differs from the value the cell had on entry.
+static bool applyRulePlan(std::string& cell, const std::vector<RuleStep>& plan,
+  std::string& scratch, std::string& original) {
+  bool touched = false;
+  for(const auto& step : plan) {
+    if(!step.rule) {
+      applyExactIndex(cell, step.exact, scratch, original, touched);
+    } else if(step.rule->matchType == "substring") {
+      assignCell(cell, applySubstringReplace(cell, *step.rule), original, touched);
+    } else if(step.regex) {
+      assignCell(cell, runRegexReplaceWithTimeout(cell, *step.regex, step.rule->replace),
+        original, touched);
+    }
+  }
+  return touched && cell != original;
+}
+
+// Rewrites rows [begin, end) in place, tallying changed cells per column
+// index.  For "*" each row's cells are walked left to right, so a worker
+// streams through its block of rows in storage order.
+static void applyToRows(std::vector<std::vector<std::string>>& rows, size_t begin, size_t end,
+  int colIndex, const std::vector<RuleStep>& plan, std::vector<int>& counts) {
+  std::string scratch, original;
+  for(size_t r = begin; r < end; r++) {
+    auto& row = rows[r];
+    if(colIndex < 0) {
+      if(counts.size() < row.size()) counts.resize(row.size(), 0);
+      for(size_t j = 0; j < row.size(); j++) {
+        if(applyRulePlan(row[j], plan, scratch, original)) counts[j]++;
+      }
+    } else if(colIndex < (int)row.size()) {
+      if(applyRulePlan(row[colIndex], plan, scratch, original)) counts[0]++;
+    }
+  }
+}
+
+static const size_t MIN_ROWS_PER_THREAD = 2048;
+
+FindReplaceResult applyFindReplaceParallel(std::vector<std::vector<std::string>> data,
   const std::string& column, const std::vector<FindReplaceRule>& rules,
-  const std::vector<std::string>& headers) {
+  const std::vector<std::string>& headers, unsigned int threadCount) {
   FindReplaceResult result;
   result.totalReplacements = 0;
   int colIndex = -1;
@@ -69,21 +194,32 @@ FindReplaceResult applyFindReplace(const std::vector<std::vector<std::string>>&
     for(size_t i = 0; i < headers.size(); i++) {
       if(headers[i] == column) { colIndex = static_cast<int>(i); break; }
     }
-    if(colIndex == -1) { result.data = data; return result; }
+    if(colIndex == -1) { result.data = std::move(data); return result; }
   }
-  result.data = data;
-  for(auto& row : result.data) {
-    if(column == "*") {
-      for(size_t j = 0; j < row.size(); j++) {
-        std::string orig = row[j];
-        for(const auto& rule : rules) row[j] = applyReplacement(row[j], rule);
-        if(row[j] != orig) result.totalReplacements++, result.replacementCounts[headers[j]]++;
-      }
-    } else if(colIndex >= 0 && colIndex < (int)row.size()) {
-      std::string orig = row[colIndex];
-      for(const auto& rule : rules) row[colIndex] = applyReplacement(row[colIndex], rule);
-      if(row[colIndex] != orig) result.totalReplacements++, result.replacementCounts[column]++;
+  std::vector<RuleStep> plan = buildRulePlan(rules);
+  unsigned int threads = threadCount == 1 ? 1 :
+    workerCount(data.size(), MIN_ROWS_PER_THREAD, threadCount);
+
+  // thread-local counters, merged into the result map once at the end
+  std::vector<std::vector<int>> counts(threads, std::vector<int>(colIndex < 0 ? 0 : 1, 0));
+  parallelChunks(data.size(), threads, [&](unsigned int t, size_t begin, size_t end) {
+    applyToRows(data, begin, end, colIndex, plan, counts[t]);
+  });
+
+  for(const auto& local : counts) {
+    for(size_t j = 0; j < local.size(); j++) {
+      if(local[j] == 0) continue;
+      result.totalReplacements += local[j];
+      if(colIndex >= 0) result.replacementCounts[column] += local[j];
+      else if(j < headers.size()) result.replacementCounts[headers[j]] += local[j];
     }
   }
+  result.data = std::move(data);
   return result;
 }
+
+FindReplaceResult applyFindReplace(const std::vector<std::vector<std::string>>& data,
+  const std::string& column, const std::vector<FindReplaceRule>& rules,
+  const std::vector<std::string>& headers) {
+  return applyFindReplaceParallel(data, column, rules, headers, 1);
+}
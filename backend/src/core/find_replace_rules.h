@@ -25,5 +25,14 @@ FindReplaceResult applyFindReplace(
   const std::string& column,
   const std::vector<FindReplaceRule>& rules,
   const std::vector<std::string>& headers);
+// Row-parallel variant: rows are partitioned across worker threads and
+// rewritten in place (pass data with std::move to avoid a copy).
+// threadCount 0 = hardware concurrency, 1 = serial.
+FindReplaceResult applyFindReplaceParallel(
+  std::vector<std::vector<std::string>> data,
+  const std::string& column,
+  const std::vector<FindReplaceRule>& rules,
+  const std::vector<std::string>& headers,
+  unsigned int threadCount = 0);
 
 #endif
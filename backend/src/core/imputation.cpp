@@ -0,0 +1,188 @@
+#include "imputation.h"
+#include "missing_values.h"
+#include "numeric_column.h"
+#include "parallel_for.h"
+#include "string_issue_detectors.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+
+bool parseNumericImpute(const std::string& name, NumericImpute& strategy) {
+  if (name == "mean") strategy = NumericImpute::MEAN;
+  else if (name == "median") strategy = NumericImpute::MEDIAN;
+  else if (name == "mode") strategy = NumericImpute::MODE;
+  else return false;
+  return true;
+}
+
+bool parseCategoricalImpute(const std::string& name, CategoricalImpute& strategy) {
+  if (name == "mode") strategy = CategoricalImpute::MODE;
+  else if (name == "dummy") strategy = CategoricalImpute::DUMMY;
+  else return false;
+  return true;
+}
+
+std::string formatFloat(double value) {
+  if (std::isnan(value)) return "nan";
+  if (std::isinf(value)) return value < 0 ? "-inf" : "inf";
+  // shortest round-trip digits and exponent, e.g. "2.9433767258382645e+01"
+  char buf[40];
+  auto res = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::scientific);
+  std::string_view sci(buf, static_cast<size_t>(res.ptr - buf));
+  std::string out;
+  if (sci[0] == '-') { out += '-'; sci.remove_prefix(1); }
+  size_t e = sci.find('e');
+  std::string digits;
+  for (char c : sci.substr(0, e)) if (c != '.') digits += c;
+  int exp = std::stoi(std::string(sci.substr(e + 1)));
+
+  if (exp < -4 || exp >= 16) {
+    out += digits[0];
+    if (digits.size() > 1) { out += '.'; out.append(digits, 1, std::string::npos); }
+    out += exp < 0 ? "e-" : "e+";
+    std::string mag = std::to_string(std::abs(exp));
+    if (mag.size() < 2) out += '0';
+    return out + mag;
+  }
+  if (exp < 0) return out + "0." + std::string(static_cast<size_t>(-exp - 1), '0') + digits;
+  const size_t intDigits = static_cast<size_t>(exp) + 1;
+  if (digits.size() <= intDigits) return out + digits + std::string(intDigits - digits.size(), '0') + ".0";
+  return out + digits.substr(0, intDigits) + "." + digits.substr(intDigits);
+}
+
+// --- per-column fill values ----------------------------------------------
+
+// Most frequent number; ties go to the smallest.
+static double numericMode(const NumericColumn& column) {
+  std::unordered_map<double, size_t> counts;
+  counts.reserve(column.count());
+  column.validity().forEachSet([&](size_t row) { counts[column.value(row)]++; });
+  double best = 0.0;
+  size_t bestCount = 0;
+  for (const auto& kv : counts)
+    if (kv.second > bestCount || (kv.second == bestCount && kv.first < best)) {
+      best = kv.first;
+      bestCount = kv.second;
+    }
+  return best;
+}
+
+// Most frequent non-empty cell; ties go to the smallest.  Counted by view,
+// without copying the cells.
+static std::string categoricalMode(const std::vector<std::vector<std::string>>& data, size_t col) {
+  std::unordered_map<std::string_view, size_t> counts;
+  for (size_t r = 1; r < data.size(); r++)
+    if (col < data[r].size() && !data[r][col].empty()) counts[data[r][col]]++;
+  std::string_view best;
+  size_t bestCount = 0;
+  for (const auto& kv : counts)
+    if (kv.second > bestCount || (kv.second == bestCount && kv.first < best)) {
+      best = kv.first;
+      bestCount = kv.second;
+    }
+  return std::string(best);
+}
+
+// Sets out.numeric and out.fillValue for column `col` (fillValue stays empty
+// when there is nothing to compute it from).
+static void fitColumn(const std::vector<std::vector<std::string>>& data, size_t col,
+                      const ImputeOptions& options, ColumnImputation& out) {
+  size_t present = 0;
+  for (size_t r = 1; r < data.size(); r++)
+    if (col < data[r].size() && !data[r][col].empty()) present++;
+
+  NumericColumn column(data, col);
+  out.numeric = out.type == ColumnType::NUMERIC ||
+                (out.type != ColumnType::BOOLEAN && present > 0 && column.count() == present);
+  if (out.numeric && column.count() > 0) {
+    double fill = 0.0;
+    switch (options.numeric) {
+      case NumericImpute::MEAN: fill = columnStats(column, STATS_MOMENTS).mean; break;
+      case NumericImpute::MEDIAN: fill = columnStats(column, STATS_MEDIAN).median; break;
+      case NumericImpute::MODE: fill = numericMode(column); break;
+    }
+    out.fillValue = formatFloat(fill);
+  } else if (!out.numeric && options.categorical == CategoricalImpute::DUMMY) {
+    out.fillValue = options.dummyValue;
+  } else if (!out.numeric && present > 0) {
+    out.fillValue = categoricalMode(data, col);
+  }
+}
+
+static size_t columnIndex(const std::vector<std::string>& header, const std::string& name) {
+  auto it = std::find(header.begin(), header.end(), name);
+  if (it == header.end()) throw std::invalid_argument("imputation: no column " + name);
+  return static_cast<size_t>(it - header.begin());
+}
+
+// Fill values for the target columns of `data`; with onlyMissing, columns
+// without an empty cell are skipped (their fill value would go unused).
+static std::vector<ColumnImputation> fitColumns(const std::vector<std::vector<std::string>>& data,
+                                                const ImputeOptions& options, bool onlyMissing) {
+  if (data.empty()) return {};
+  const std::vector<std::string>& header = data[0];
+  std::vector<size_t> targets;
+  if (options.columns.empty()) {
+    for (size_t c = 0; c < header.size(); c++) targets.push_back(c);
+  } else {
+    for (const auto& name : options.columns) targets.push_back(columnIndex(header, name));
+  }
+  if (onlyMissing) {
+    MissingValueMap missing = detectMissingValues(data);
+    targets.erase(std::remove_if(targets.begin(), targets.end(),
+                                 [&](size_t c) { return missing.columnCount(c) == 0; }),
+                  targets.end());
+  }
+
+  ColumnTypeResult types = detectColumnTypes(data);
+  std::vector<ColumnImputation> columns(targets.size());
+  for (size_t i = 0; i < targets.size(); i++) {
+    columns[i].name = header[targets[i]];
+    if (targets[i] < types.types.size()) columns[i].type = types.types[targets[i]];
+  }
+  unsigned int threads = workerCount(targets.size(), 1, options.threadCount);
+  parallelChunks(targets.size(), threads, [&](unsigned int, size_t b, size_t e) {
+    for (size_t i = b; i < e; i++) fitColumn(data, targets[i], options, columns[i]);
+  });
+  columns.erase(std::remove_if(columns.begin(), columns.end(),
+                               [](const ColumnImputation& c) { return c.fillValue.empty(); }),
+                columns.end());
+  return columns;
+}
+
+std::vector<ColumnImputation> fitImputation(const std::vector<std::vector<std::string>>& data,
+                                            const ImputeOptions& options) {
+  return fitColumns(data, options, false);
+}
+
+ImputeResult applyImputation(std::vector<std::vector<std::string>> data,
+                             const std::vector<ColumnImputation>& fills) {
+  ImputeResult result;
+  if (data.empty()) return result;
+  MissingValueMap missing = detectMissingValues(data);
+  for (ColumnImputation column : fills) {
+    auto it = std::find(data[0].begin(), data[0].end(), column.name);
+    if (it == data[0].end()) continue;
+    const size_t col = static_cast<size_t>(it - data[0].begin());
+    column.filled = 0;
+    // short rows are missing the cell entirely and are left as they are
+    missing.column(col).forEachSet([&](size_t r) {
+      if (col >= data[r].size()) return;
+      data[r][col] = column.fillValue;
+      column.filled++;
+    });
+    if (column.filled == 0) continue;
+    result.cellsFilled += column.filled;
+    result.columns.push_back(std::move(column));
+  }
+  result.data = std::move(data);
+  return result;
+}
+
+ImputeResult imputeMissingValues(std::vector<std::vector<std::string>> data, const ImputeOptions& options) {
+  auto fills = fitColumns(data, options, true);
+  return applyImputation(std::move(data), fills);
+}
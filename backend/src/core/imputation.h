@@ -0,0 +1,69 @@
+#ifndef IMPUTATION_H
+#define IMPUTATION_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "column_type_detection.h"
+
+// Column-level missing-value imputation: every empty cell of a column is
+// filled with one value computed from the column's other cells.
+//
+// Columns detected as NUMERIC, or whose every non-empty cell is a number
+// (IDs, codes), take the numeric strategy and get the fill value formatted
+// as a float ("29.433767258382645", "28.0"), matching the pandas-produced
+// impute_* datasets.  BOOLEAN and text columns take the categorical
+// strategy.  Mode ties go to the smallest value.  Columns with no values at
+// all are left empty.
+
+enum class NumericImpute { MEAN, MEDIAN, MODE };
+enum class CategoricalImpute { MODE, DUMMY };
+
+struct ImputeOptions {
+  NumericImpute numeric = NumericImpute::MEAN;
+  CategoricalImpute categorical = CategoricalImpute::MODE;
+  std::string dummyValue = "missing";
+  std::vector<std::string> columns;  // header names; empty = every column
+  unsigned int threadCount = 0;      // 0 = hardware concurrency
+};
+
+struct ColumnImputation {
+  std::string name;
+  ColumnType type = ColumnType::GENERIC_TEXT;
+  bool numeric = false;
+  std::string fillValue;
+  size_t filled = 0;
+};
+
+struct ImputeResult {
+  std::vector<std::vector<std::string>> data;
+  std::vector<ColumnImputation> columns;  // one per column with cells filled
+  size_t cellsFilled = 0;
+};
+
+// "mean" / "median" / "mode", and "mode" / "dummy"; false for anything else.
+bool parseNumericImpute(const std::string& name, NumericImpute& strategy);
+bool parseCategoricalImpute(const std::string& name, CategoricalImpute& strategy);
+
+// Fill values computed from `data` for the columns in options.columns (or
+// all of them), leaving out columns with nothing to fill from.  Columns are
+// independent and run on worker threads.  Throws std::invalid_argument if
+// options.columns names a column that does not exist.
+std::vector<ColumnImputation> fitImputation(const std::vector<std::vector<std::string>>& data,
+                                            const ImputeOptions& options);
+
+// Fills the empty cells of each fitted column (matched by header name) in
+// `data`; a table fitted on a training split fills its test split with the
+// training statistics.  Fitted columns that `data` lacks are skipped.
+ImputeResult applyImputation(std::vector<std::vector<std::string>> data,
+                             const std::vector<ColumnImputation>& fills);
+
+// fitImputation and applyImputation on the same table, fitting only the
+// columns that have empty cells.
+ImputeResult imputeMissingValues(std::vector<std::vector<std::string>> data, const ImputeOptions& options);
+
+// Shortest text that reads back as `value`, laid out like Python's float
+// repr: "28.0", "0.1", "1e+16", "1.5e-05".
+std::string formatFloat(double value);
+
+#endif
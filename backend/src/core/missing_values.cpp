@@ -0,0 +1,26 @@
+#include "missing_values.h"
+
+void MissingValueMap::addRow(const std::vector<std::string>& row) {
+  const bool header = rows_ == 0;
+  for (size_t c = 0; c < columns_.size(); c++)
+    columns_[c].push_back(!header && (c >= row.size() || row[c].empty()));
+  rows_++;
+}
+
+size_t MissingValueMap::total() const {
+  size_t n = 0;
+  for (const auto& column : columns_) n += column.count();
+  return n;
+}
+
+std::vector<uint32_t> MissingValueMap::rowCounts() const {
+  std::vector<uint32_t> counts(rows_, 0);
+  for (const auto& column : columns_) column.forEachSet([&](size_t row) { counts[row]++; });
+  return counts;
+}
+
+MissingValueMap detectMissingValues(const std::vector<std::vector<std::string>>& data) {
+  MissingValueMap map(data.empty() ? 0 : data[0].size());
+  for (const auto& row : data) map.addRow(row);
+  return map;
+}
@@ -0,0 +1,40 @@
+#ifndef MISSING_VALUES_H
+#define MISSING_VALUES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "bitmap.h"
+
+// Missing cells as one packed bitmap per column: bit r of column c is set
+// when row r has an empty cell there, or is too short to reach it.  The
+// header (row 0) is never missing.  Counts are popcounts, so a column costs
+// rows/64 word reads; cells beyond the header's width are not tracked.
+class MissingValueMap {
+public:
+  MissingValueMap() = default;
+  explicit MissingValueMap(size_t columns) : columns_(columns) {}
+
+  // Rows are appended in order, the header first, so the map can be filled
+  // while a CsvRecordReader streams records without keeping the table.
+  void addRow(const std::vector<std::string>& row);
+
+  size_t rows() const { return rows_; }
+  size_t columns() const { return columns_.size(); }
+  const RowBitmap& column(size_t c) const { return columns_[c]; }
+  bool missing(size_t row, size_t c) const { return columns_[c].test(row); }
+  size_t columnCount(size_t c) const { return columns_[c].count(); }
+  size_t total() const;
+  // Missing cells per row, header included (always 0).
+  std::vector<uint32_t> rowCounts() const;
+
+private:
+  std::vector<RowBitmap> columns_;
+  size_t rows_ = 0;
+};
+
+// Map of a parsed table; its header fixes the number of columns.
+MissingValueMap detectMissingValues(const std::vector<std::vector<std::string>>& data);
+
+#endif
@@ -1,39 +1,121 @@
 #include "structural_cleaners.h"
-#include <cctype>
+#include "parallel_for.h"
 #include <algorithm>
+#include <cstring>
 
-bool isNumeric(const std::string& s){
-  if(s.empty()) return false;
-  for(char c:s) if(!std::isdigit(c)) return false;
-  return true;
+static const size_t MIN_ROWS_PER_SORT_THREAD=1<<15;
+static const char DIGIT_RUN='0';  // orders a digit run where its first digit would sort
+
+static bool isDigit(char c){ return c>='0'&&c<='9'; }
+
+// Each digit run becomes DIGIT_RUN, its significant-digit count as four
+// big-endian bytes, then the digits without leading zeros: runs compare by
+// length first, so numbers of any size order by value ("9" < "10" <
+// "99999999999999999999"). Other bytes are copied, and compare unsigned.
+void appendNaturalSortKey(std::string_view cell, std::string& out){
+  size_t i=0;
+  while(i<cell.size()){
+    if(!isDigit(cell[i])){ out+=cell[i++]; continue; }
+    while(i<cell.size()&&cell[i]=='0'&&i+1<cell.size()&&isDigit(cell[i+1])) i++;
+    size_t start=i;
+    while(i<cell.size()&&isDigit(cell[i])) i++;
+    size_t len=i-start;
+    if(len==1&&cell[start]=='0') len=0;  // "0", "000": no significant digits
+    out+=DIGIT_RUN;
+    for(int shift=24;shift>=0;shift-=8) out+=static_cast<char>((len>>shift)&0xff);
+    out.append(cell.data()+i-len,len);
+  }
+}
+
+std::string naturalSortKey(std::string_view cell){
+  std::string key;
+  appendNaturalSortKey(cell,key);
+  return key;
 }
 
-int naturalCompare(const std::string& a, const std::string& b){
-  size_t i=0,j=0;
-  while(i<a.length() && j<b.length()){
-    if(std::isdigit(a[i]) && std::isdigit(b[j])){
-      int numA=0,numB=0;
-      while(i<a.length() && std::isdigit(a[i]))
-        numA=numA*10+(a[i++]-'0');
-      while(j<b.length() && std::isdigit(b[j]))
-        numB=numB*10+(b[j++]-'0');
-      if(numA!=numB) return numA<numB?-1:1;
-    }else{
-      if(a[i]!=b[j]) return a[i]<b[j]?-1:1;
-      i++;j++;
-    }
+namespace {
+// All keys in one buffer; key i is [offsets[i], offsets[i+1]).
+struct KeyArena{
+  std::string bytes;
+  std::vector<size_t> offsets;
+  bool less(uint32_t a, uint32_t b) const{
+    size_t la=offsets[a+1]-offsets[a], lb=offsets[b+1]-offsets[b];
+    int c=std::memcmp(bytes.data()+offsets[a],bytes.data()+offsets[b],std::min(la,lb));
+    return c<0||(c==0&&la<lb);
   }
-  return a.length()<b.length()?-1:(a.length()>b.length()?1:0);
+};
 }
 
-std::vector<std::vector<std::string>> naturalSort(
-  const std::vector<std::vector<std::string>>& data, int colIndex){
-  auto sorted=data;
-  std::sort(sorted.begin(),sorted.end(),
-    [colIndex](const auto& a, const auto& b){
-      if(colIndex<0 || colIndex>=(int)a.size()) return false;
-      return naturalCompare(a[colIndex],b[colIndex])<0;
+// Stable, so rows with equal keys keep their input order. Large inputs are
+// sorted in per-thread runs and merged pairwise, each round in parallel.
+static void sortPermutation(std::vector<uint32_t>& order, const KeyArena& keys, unsigned int threadCount){
+  auto less=[&keys](uint32_t a, uint32_t b){ return keys.less(a,b); };
+  unsigned int threads=workerCount(order.size(),MIN_ROWS_PER_SORT_THREAD,threadCount);
+  if(threads<=1){ std::stable_sort(order.begin(),order.end(),less); return; }
+
+  std::vector<size_t> bounds(threads+1);
+  for(unsigned int t=0;t<=threads;t++) bounds[t]=order.size()*t/threads;
+  parallelChunks(threads,threads,[&](unsigned int,size_t b,size_t e){
+    for(size_t t=b;t<e;t++) std::stable_sort(order.begin()+bounds[t],order.begin()+bounds[t+1],less);
+  });
+  std::vector<uint32_t> buffer(order.size());
+  while(bounds.size()>2){
+    size_t pairs=(bounds.size()-1)/2;
+    parallelChunks(pairs,static_cast<unsigned int>(pairs),[&](unsigned int,size_t b,size_t e){
+      for(size_t p=b;p<e;p++){
+        size_t lo=bounds[2*p], mid=bounds[2*p+1], hi=bounds[2*p+2];
+        std::merge(order.begin()+lo,order.begin()+mid,order.begin()+mid,order.begin()+hi,buffer.begin()+lo,less);
+      }
     });
+    // an odd run out carries over unmerged
+    if((bounds.size()-1)%2==1)
+      std::copy(order.begin()+bounds[bounds.size()-2],order.end(),buffer.begin()+bounds[bounds.size()-2]);
+    order.swap(buffer);
+    std::vector<size_t> next;
+    for(size_t i=0;i<bounds.size();i+=2) next.push_back(bounds[i]);
+    if(next.back()!=order.size()) next.push_back(order.size());
+    bounds.swap(next);
+  }
+}
+
+std::vector<uint32_t> naturalSortOrder(const std::vector<std::vector<std::string>>& data, int colIndex,
+  unsigned int threadCount){
+  std::vector<uint32_t> order;
+  if(data.size()<2) return order;
+  const size_t col=static_cast<size_t>(colIndex);
+  KeyArena keys;
+  keys.offsets.reserve(data.size());
+  keys.offsets.push_back(0);
+  // index i is data row i+1; a row too short for the column sorts as empty
+  for(size_t r=1;r<data.size();r++){
+    if(col<data[r].size()) appendNaturalSortKey(data[r][col],keys.bytes);
+    keys.offsets.push_back(keys.bytes.size());
+  }
+  order.resize(data.size()-1);
+  for(size_t i=0;i<order.size();i++) order[i]=static_cast<uint32_t>(i);
+  sortPermutation(order,keys,threadCount);
+  for(auto& i:order) i++;
+  return order;
+}
+
+std::vector<std::vector<std::string>> naturalSort(
+  std::vector<std::vector<std::string>>&& data, int colIndex, unsigned int threadCount){
+  if(data.empty()||colIndex<0||colIndex>=(int)data[0].size()) return std::move(data);
+  auto order=naturalSortOrder(data,colIndex,threadCount);
+  std::vector<std::vector<std::string>> sorted;
+  sorted.reserve(data.size());
+  sorted.push_back(std::move(data[0]));
+  for(uint32_t r:order) sorted.push_back(std::move(data[r]));
   return sorted;
 }
 
+std::vector<std::vector<std::string>> naturalSort(
+  const std::vector<std::vector<std::string>>& data, int colIndex, unsigned int threadCount){
+  if(data.empty()||colIndex<0||colIndex>=(int)data[0].size()) return data;
+  auto order=naturalSortOrder(data,colIndex,threadCount);
+  std::vector<std::vector<std::string>> sorted;
+  sorted.reserve(data.size());
+  sorted.push_back(data[0]);
+  for(uint32_t r:order) sorted.push_back(data[r]);
+  return sorted;
+}
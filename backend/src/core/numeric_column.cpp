@@ -0,0 +1,192 @@
+#include "numeric_column.h"
+#include "string_issue_detectors.h"
+#include <algorithm>
+#include <cmath>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define NUMERIC_SSE2 1
+#endif
+
+NumericColumn::NumericColumn(const std::vector<std::vector<std::string>>& data, size_t column) {
+  assign(data, column);
+}
+
+void NumericColumn::assign(const std::vector<std::vector<std::string>>& data, size_t column) {
+  values_.assign(data.size(), 0.0);
+  valid_.assign(data.size());
+  count_ = 0;
+  for (size_t row = 1; row < data.size(); row++) {
+    if (column < data[row].size() && parseNumericCell(data[row][column], values_[row])) {
+      valid_.set(row);
+      count_++;
+    } else {
+      values_[row] = 0.0;
+    }
+  }
+}
+
+void NumericColumn::gather(std::vector<double>& out) const {
+  out.clear();
+  out.reserve(count_);
+  valid_.forEachSet([&](size_t row) { out.push_back(values_[row]); });
+}
+
+// --- reductions ----------------------------------------------------------
+
+// Two independent accumulators of two lanes each, so consecutive adds do not
+// wait on each other; the scalar tail picks up the last 0-3 values.
+static double sumOf(const double* p, size_t n) {
+  size_t i = 0;
+  double sum = 0.0;
+#ifdef NUMERIC_SSE2
+  __m128d a = _mm_setzero_pd(), b = _mm_setzero_pd();
+  for (; i + 4 <= n; i += 4) {
+    a = _mm_add_pd(a, _mm_loadu_pd(p + i));
+    b = _mm_add_pd(b, _mm_loadu_pd(p + i + 2));
+  }
+  double lanes[2];
+  _mm_storeu_pd(lanes, _mm_add_pd(a, b));
+  sum = lanes[0] + lanes[1];
+#endif
+  for (; i < n; i++) sum += p[i];
+  return sum;
+}
+
+static double squaredDeviationOf(const double* p, size_t n, double mean) {
+  size_t i = 0;
+  double sum = 0.0;
+#ifdef NUMERIC_SSE2
+  const __m128d m = _mm_set1_pd(mean);
+  __m128d a = _mm_setzero_pd(), b = _mm_setzero_pd();
+  for (; i + 4 <= n; i += 4) {
+    __m128d da = _mm_sub_pd(_mm_loadu_pd(p + i), m);
+    __m128d db = _mm_sub_pd(_mm_loadu_pd(p + i + 2), m);
+    a = _mm_add_pd(a, _mm_mul_pd(da, da));
+    b = _mm_add_pd(b, _mm_mul_pd(db, db));
+  }
+  double lanes[2];
+  _mm_storeu_pd(lanes, _mm_add_pd(a, b));
+  sum = lanes[0] + lanes[1];
+#endif
+  for (; i < n; i++) sum += (p[i] - mean) * (p[i] - mean);
+  return sum;
+}
+
+// n must be at least 1
+static void minMaxOf(const double* p, size_t n, double& lo, double& hi) {
+  size_t i = 0;
+  lo = hi = p[0];
+#ifdef NUMERIC_SSE2
+  if (n >= 2) {
+    __m128d mn = _mm_loadu_pd(p), mx = mn;
+    for (i = 2; i + 2 <= n; i += 2) {
+      __m128d v = _mm_loadu_pd(p + i);
+      mn = _mm_min_pd(mn, v);
+      mx = _mm_max_pd(mx, v);
+    }
+    double l[2], h[2];
+    _mm_storeu_pd(l, mn);
+    _mm_storeu_pd(h, mx);
+    lo = std::min(l[0], l[1]);
+    hi = std::max(h[0], h[1]);
+  }
+#endif
+  for (; i < n; i++) {
+    lo = std::min(lo, p[i]);
+    hi = std::max(hi, p[i]);
+  }
+}
+
+// Median of buf[0, n), reordering it; afterwards buf[n/2] holds the upper
+// middle value with everything before it no larger.
+static double selectMedian(std::vector<double>& buf) {
+  const size_t mid = buf.size() / 2;
+  std::nth_element(buf.begin(), buf.begin() + mid, buf.end());
+  double upper = buf[mid];
+  if (buf.size() % 2 == 1) return upper;
+  double lower = *std::max_element(buf.begin(), buf.begin() + mid);
+  return (lower + upper) / 2.0;
+}
+
+// --- statistics ----------------------------------------------------------
+
+ColumnStats columnStats(const NumericColumn& column, std::vector<double>& buf, unsigned fields) {
+  ColumnStats stats;
+  column.gather(buf);
+  const size_t n = buf.size();
+  stats.count = n;
+  if (n == 0) return stats;
+
+  if (fields & STATS_MOMENTS) {
+    stats.mean = sumOf(buf.data(), n) / static_cast<double>(n);
+    if (n > 1) stats.variance = squaredDeviationOf(buf.data(), n, stats.mean) / static_cast<double>(n - 1);
+    stats.stddev = std::sqrt(stats.variance);
+    minMaxOf(buf.data(), n, stats.min, stats.max);
+  }
+
+  const size_t mid = n / 2, lowK = n / 4, highK = 3 * n / 4;
+  const bool median = fields & (STATS_MEDIAN | STATS_MAD);
+  if (median) stats.median = selectMedian(buf);
+  if (fields & STATS_QUARTILES) {
+    if (median) {
+      // the median selection partitions around n/2, so the quartiles only
+      // need to search one side of it
+      if (lowK < mid) std::nth_element(buf.begin(), buf.begin() + lowK, buf.begin() + mid);
+      if (highK > mid) std::nth_element(buf.begin() + mid + 1, buf.begin() + highK, buf.end());
+    } else {
+      std::nth_element(buf.begin(), buf.begin() + lowK, buf.end());
+      if (highK > lowK) std::nth_element(buf.begin() + lowK + 1, buf.begin() + highK, buf.end());
+    }
+    stats.q1 = buf[lowK];
+    stats.q3 = buf[highK];
+  }
+
+  if (fields & STATS_MAD) {
+    for (double& v : buf) v = std::fabs(v - stats.median);
+    stats.mad = selectMedian(buf);
+  }
+  return stats;
+}
+
+ColumnStats columnStats(const NumericColumn& column, unsigned fields) {
+  std::vector<double> buf;
+  return columnStats(column, buf, fields);
+}
+
+// Interpolated quantile of buf[from, n) where every value before `from` is
+// no larger than any at or after it; selects within that range only.
+static double selectQuantile(std::vector<double>& buf, size_t from, double q) {
+  q = std::min(std::max(q, 0.0), 1.0);
+  const double pos = q * static_cast<double>(buf.size() - 1);
+  const size_t lo = std::max(static_cast<size_t>(pos), from);
+  std::nth_element(buf.begin() + static_cast<std::ptrdiff_t>(from), buf.begin() + static_cast<std::ptrdiff_t>(lo),
+                   buf.end());
+  double value = buf[lo];
+  double frac = pos - static_cast<double>(lo);
+  if (frac > 0.0 && lo + 1 < buf.size()) {
+    double next = *std::min_element(buf.begin() + static_cast<std::ptrdiff_t>(lo) + 1, buf.end());
+    value += frac * (next - value);
+  }
+  return value;
+}
+
+double columnQuantile(const NumericColumn& column, double q) {
+  std::vector<double> buf;
+  column.gather(buf);
+  if (buf.empty()) return 0.0;
+  return selectQuantile(buf, 0, q);
+}
+
+void columnQuantiles(const NumericColumn& column, std::vector<double>& buf, double qLow,
+                     double qHigh, double& low, double& high) {
+  column.gather(buf);
+  if (buf.empty()) {
+    low = high = 0.0;
+    return;
+  }
+  low = selectQuantile(buf, 0, qLow);
+  // buf[0, k] now holds the k+1 smallest values, k = floor of qLow's position
+  qLow = std::min(std::max(qLow, 0.0), 1.0);
+  size_t k = static_cast<size_t>(qLow * static_cast<double>(buf.size() - 1));
+  high = selectQuantile(buf, k, qHigh);
+}
@@ -0,0 +1,77 @@
+#ifndef NUMERIC_COLUMN_H
+#define NUMERIC_COLUMN_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "bitmap.h"
+
+// One column of a parsed table converted once to numbers: a dense double per
+// row (0.0 where the cell is not numeric) and a validity bit per row.  Row
+// indices match the table, so row 0 (the header) is never valid.  Statistics,
+// outlier methods and imputation all read this instead of re-parsing cells.
+class NumericColumn {
+public:
+  NumericColumn() = default;
+  NumericColumn(const std::vector<std::vector<std::string>>& data, size_t column);
+
+  // Re-parses for another column, reusing this column's buffers, so a pass
+  // over every column of a table allocates once.
+  void assign(const std::vector<std::vector<std::string>>& data, size_t column);
+
+  size_t rows() const { return values_.size(); }
+  size_t count() const { return count_; }
+  bool valid(size_t row) const { return valid_.test(row); }
+  double value(size_t row) const { return values_[row]; }
+  const RowBitmap& validity() const { return valid_; }
+
+  // The valid values, in row order, packed into `out` (replacing its contents).
+  void gather(std::vector<double>& out) const;
+
+private:
+  std::vector<double> values_;
+  RowBitmap valid_;
+  size_t count_ = 0;
+};
+
+struct ColumnStats {
+  size_t count = 0;
+  double mean = 0.0;
+  double variance = 0.0;  // sample variance (n - 1), 0 below two values
+  double stddev = 0.0;
+  double min = 0.0;
+  double max = 0.0;
+  double median = 0.0;    // mean of the two middle values for even counts
+  double mad = 0.0;       // median absolute deviation from the median
+  double q1 = 0.0;        // order statistics n/4 and 3n/4, as the IQR fences use
+  double q3 = 0.0;
+};
+
+// Which ColumnStats fields columnStats fills in; count is always set.
+enum StatFields : unsigned {
+  STATS_MOMENTS = 1,    // mean, variance, stddev, min, max
+  STATS_MEDIAN = 2,
+  STATS_MAD = 4,        // implies STATS_MEDIAN
+  STATS_QUARTILES = 8,  // q1, q3
+  STATS_ALL = 15
+};
+
+// Sum, min/max and squared deviations are SSE2 reductions over the packed
+// values; median, quartiles and MAD are selections, not sorts, and only the
+// requested ones are made.  All zero for a column with no numeric cells.
+// The values are gathered into `scratch`, so callers looping over columns
+// can pass one buffer for all of them.
+ColumnStats columnStats(const NumericColumn& column, std::vector<double>& scratch,
+                        unsigned fields = STATS_ALL);
+ColumnStats columnStats(const NumericColumn& column, unsigned fields = STATS_ALL);
+
+// Linearly interpolated quantile (q in [0, 1]) of the valid values, the
+// pandas / numpy default.  0 for an empty column.
+double columnQuantile(const NumericColumn& column, double q);
+
+// Quantiles qLow <= qHigh from one gather into `scratch`; the second
+// selection only searches above the first.
+void columnQuantiles(const NumericColumn& column, std::vector<double>& scratch, double qLow,
+                     double qHigh, double& low, double& high);
+
+#endif
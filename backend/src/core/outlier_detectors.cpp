@@ -1,50 +1,94 @@
 #include "string_issue_detectors.h"
+#include "numeric_column.h"
 #include <algorithm>
-#include <set>
+#include <charconv>
 #include <cmath>
+#include <cstdint>
 
-std::vector<int> detectOutliers(const std::vector<std::vector<std::string>>& data){
-  std::vector<int> outlierRows;
-  if(data.size()<2) return outlierRows;
-  auto isNumeric=[](const std::string& str)->bool{
-    if(str.empty()) return false;
-    size_t start=0;
-    if(str[0]=='-'||str[0]=='+') start=1;
-    if(start>=str.length()) return false;
-    bool hasDecimal=false;
-    for(size_t i=start;i<str.length();i++){
-      if(str[i]=='.'){
-        if(hasDecimal) return false;
-        hasDecimal=true;
-      }else if(str[i]<'0'||str[i]>'9') return false;
-    }
-    return true;
-  };
+// Optional sign, digits with at most one '.', at least one digit; parsed with
+// std::from_chars (locale-free, no exceptions, rounds like std::stod).
+bool parseNumericCell(const std::string& str, double& value){
+  size_t start=0;
+  if(!str.empty()&&(str[0]=='-'||str[0]=='+')) start=1;
+  bool hasDecimal=false,hasDigit=false;
+  for(size_t i=start;i<str.length();i++){
+    if(str[i]=='.'){
+      if(hasDecimal) return false;
+      hasDecimal=true;
+    }else if(str[i]<'0'||str[i]>'9') return false;
+    else hasDigit=true;
+  }
+  if(!hasDigit) return false;
+  // from_chars takes a leading '-' but not '+'
+  const char* first=str.data()+(str[0]=='+'?1:0);
+  const char* last=str.data()+str.size();
+  auto res=std::from_chars(first,last,value);
+  return res.ec==std::errc() && res.ptr==last;
+}
+
+bool parseOutlierMethod(const std::string& name, OutlierMethod& method){
+  if(name=="iqr") method=OutlierMethod::IQR;
+  else if(name=="zscore") method=OutlierMethod::ZSCORE;
+  else if(name=="modified-zscore") method=OutlierMethod::MODIFIED_ZSCORE;
+  else if(name=="percentile") method=OutlierMethod::PERCENTILE;
+  else return false;
+  return true;
+}
+
+static double defaultThreshold(OutlierMethod method){
+  switch(method){
+    case OutlierMethod::ZSCORE: return 3.0;
+    case OutlierMethod::MODIFIED_ZSCORE: return 3.5;
+    case OutlierMethod::PERCENTILE: return 0.01;
+    default: return 1.5;
+  }
+}
+
+RowBitmap detectOutlierRows(const std::vector<std::vector<std::string>>& data, const OutlierOptions& options){
+  RowBitmap outliers(data.size());
+  if(data.size()<2) return outliers;
+  const double t=options.threshold>0?options.threshold:defaultThreshold(options.method);
   size_t numCols=data[0].size();
-  std::set<int> outlierSet;
+  // one column and one selection buffer, reused for every column
+  NumericColumn column;
+  std::vector<double> scratch;
+  unsigned fields=options.method==OutlierMethod::ZSCORE?STATS_MOMENTS
+                 :options.method==OutlierMethod::MODIFIED_ZSCORE?STATS_MAD:STATS_QUARTILES;
   for(size_t col=0;col<numCols;col++){
-    std::vector<double> values;
-    std::vector<int> rowIndices;
-    for(size_t row=1;row<data.size();row++){
-      if(col<data[row].size()&&isNumeric(data[row][col])){
-        values.push_back(std::stod(data[row][col]));
-        rowIndices.push_back(static_cast<int>(row));
+    column.assign(data,col);
+    if(column.count()<4) continue;
+    double lower,upper;
+    if(options.method==OutlierMethod::PERCENTILE){
+      double tail=std::min(t,0.5);
+      columnQuantiles(column,scratch,tail,1.0-tail,lower,upper);
+    }else{
+      ColumnStats s=columnStats(column,scratch,fields);
+      if(options.method==OutlierMethod::ZSCORE){
+        if(s.stddev==0.0) continue;
+        lower=s.mean-t*s.stddev;
+        upper=s.mean+t*s.stddev;
+      }else if(options.method==OutlierMethod::MODIFIED_ZSCORE){
+        // Iglewicz-Hoaglin: 0.6745*(x-median)/MAD, so |x-median| > t*MAD/0.6745
+        if(s.mad==0.0) continue;
+        lower=s.median-t*s.mad/0.6745;
+        upper=s.median+t*s.mad/0.6745;
+      }else{
+        double iqr=s.q3-s.q1;
+        lower=s.q1-t*iqr;
+        upper=s.q3+t*iqr;
       }
     }
-    if(values.size()<4) continue;
-    std::vector<double> sorted=values;
-    std::sort(sorted.begin(),sorted.end());
-    size_t n=sorted.size();
-    double q1=sorted[n/4];
-    double q3=sorted[3*n/4];
-    double iqr=q3-q1;
-    double lower=q1-1.5*iqr;
-    double upper=q3+1.5*iqr;
-    for(size_t i=0;i<values.size();i++){
-      if(values[i]<lower||values[i]>upper) outlierSet.insert(rowIndices[i]);
-    }
+    column.validity().forEachSet([&](size_t row){
+      double v=column.value(row);
+      if(v<lower||v>upper) outliers.set(row);
+    });
   }
-  for(int row : outlierSet) outlierRows.push_back(row);
+  return outliers;
+}
+
+std::vector<int> detectOutliers(const std::vector<std::vector<std::string>>& data, const OutlierOptions& options){
+  std::vector<int> outlierRows;
+  detectOutlierRows(data,options).forEachSet([&](size_t row){ outlierRows.push_back(static_cast<int>(row)); });
   return outlierRows;
 }
 
@@ -0,0 +1,55 @@
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+// Number of worker threads for a job of `items` units, giving each thread at
+// least `minPerThread` units.  `requested` overrides the hardware count
+// (0 = use std::thread::hardware_concurrency()).
+inline unsigned int workerCount(size_t items, size_t minPerThread, unsigned int requested = 0) {
+  unsigned int hw = requested ? requested : std::thread::hardware_concurrency();
+  if (hw == 0) hw = 1;
+  size_t byWork = items / std::max<size_t>(1, minPerThread);
+  if (byWork == 0) byWork = 1;
+  return static_cast<unsigned int>(std::min<size_t>(hw, byWork));
+}
+
+// Split [0, n) into `threads` contiguous chunks and call
+// fn(chunkIndex, begin, end) for each.  Chunk 0 runs on the calling thread;
+// the first exception thrown by any chunk is rethrown after all have joined.
+template <typename Fn>
+void parallelChunks(size_t n, unsigned int threads, Fn&& fn) {
+  if (threads <= 1 || n <= 1) {
+    fn(0u, size_t(0), n);
+    return;
+  }
+  threads = static_cast<unsigned int>(std::min<size_t>(threads, n));
+  std::vector<std::exception_ptr> errors(threads);
+  std::vector<std::thread> pool;
+  pool.reserve(threads - 1);
+  size_t chunk = n / threads, extra = n % threads;
+  auto bounds = [&](unsigned int t, size_t& b, size_t& e) {
+    b = t * chunk + std::min<size_t>(t, extra);
+    e = b + chunk + (t < extra ? 1 : 0);
+  };
+  for (unsigned int t = 1; t < threads; t++) {
+    pool.emplace_back([&, t]() {
+      size_t b, e;
+      bounds(t, b, e);
+      try { fn(t, b, e); } catch (...) { errors[t] = std::current_exception(); }
+    });
+  }
+  {
+    size_t b, e;
+    bounds(0, b, e);
+    try { fn(0u, b, e); } catch (...) { errors[0] = std::current_exception(); }
+  }
+  for (auto& th : pool) th.join();
+  for (auto& err : errors) if (err) std::rethrow_exception(err);
+}
+
+#endif
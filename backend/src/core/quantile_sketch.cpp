@@ -0,0 +1,191 @@
+#include "quantile_sketch.h"
+#include "csv_parser.h"
+#include "parallel_for.h"
+#include "string_issue_detectors.h"
+#include <algorithm>
+#include <cmath>
+
+static const double KLL_CAPACITY_DECAY = 2.0 / 3.0;
+static const size_t MIN_BYTES_PER_THREAD = 1 << 20;
+
+// --- KLL sketch ----------------------------------------------------------
+
+KllSketch::KllSketch(uint32_t k, uint64_t seed) : k_(std::max<uint32_t>(k, 8)), rng_(seed) {
+  levels_.emplace_back();
+  maxSize_ = capacity(0);
+}
+
+// Top level holds k items; each level below holds 2/3 as many, down to 2.
+size_t KllSketch::capacity(size_t level) const {
+  size_t depth = levels_.size() - 1 - level;
+  double cap = std::ceil(k_ * std::pow(KLL_CAPACITY_DECAY, static_cast<double>(depth)));
+  return std::max<size_t>(2, static_cast<size_t>(cap));
+}
+
+size_t KllSketch::retained() const {
+  size_t n = 0;
+  for (const auto& level : levels_) n += level.size();
+  return n;
+}
+
+void KllSketch::update(double value) {
+  levels_[0].push_back(value);
+  count_++;
+  if (++size_ >= maxSize_) compress();
+}
+
+// Compact the lowest full level: sort it, keep an odd item out, and promote
+// every other item from a random offset.  One level per call is enough to
+// get back under maxSize_.
+void KllSketch::compress() {
+  for (size_t h = 0; h < levels_.size(); h++) {
+    if (levels_[h].size() < capacity(h)) continue;
+    if (h + 1 == levels_.size()) levels_.emplace_back();
+    std::vector<double>& level = levels_[h];
+    std::sort(level.begin(), level.end());
+    double held = 0.0;
+    bool odd = level.size() % 2 == 1;
+    if (odd) { held = level.back(); level.pop_back(); }
+    size_t offset = static_cast<size_t>(rng_() & 1);
+    std::vector<double>& up = levels_[h + 1];
+    for (size_t i = offset; i < level.size(); i += 2) up.push_back(level[i]);
+    level.clear();
+    if (odd) level.push_back(held);
+    break;
+  }
+  size_ = retained();
+  maxSize_ = 0;
+  for (size_t h = 0; h < levels_.size(); h++) maxSize_ += capacity(h);
+}
+
+void KllSketch::merge(const KllSketch& other) {
+  while (levels_.size() < other.levels_.size()) levels_.emplace_back();
+  for (size_t h = 0; h < other.levels_.size(); h++)
+    levels_[h].insert(levels_[h].end(), other.levels_[h].begin(), other.levels_[h].end());
+  count_ += other.count_;
+  size_ = retained();
+  maxSize_ = 0;
+  for (size_t h = 0; h < levels_.size(); h++) maxSize_ += capacity(h);
+  while (size_ >= maxSize_) compress();
+}
+
+double KllSketch::quantile(double q) const {
+  if (count_ == 0) return 0.0;
+  std::vector<std::pair<double, uint64_t>> weighted;
+  weighted.reserve(size_);
+  for (size_t h = 0; h < levels_.size(); h++)
+    for (double v : levels_[h]) weighted.push_back({v, uint64_t(1) << h});
+  std::sort(weighted.begin(), weighted.end());
+  q = std::min(std::max(q, 0.0), 1.0);
+  uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(count_));
+  uint64_t cumulative = 0;
+  for (const auto& item : weighted) {
+    cumulative += item.second;
+    if (cumulative > rank) return item.first;
+  }
+  return weighted.back().first;
+}
+
+// --- per-column fences ---------------------------------------------------
+
+ColumnQuantileSketches::ColumnQuantileSketches(size_t columns, uint64_t seed) {
+  columns_.reserve(columns);
+  for (size_t c = 0; c < columns; c++) columns_.emplace_back(200, seed + c);
+}
+
+void ColumnQuantileSketches::addRow(const std::vector<std::string>& row) {
+  double v;
+  for (size_t c = 0; c < columns_.size() && c < row.size(); c++)
+    if (parseNumericCell(row[c], v)) columns_[c].update(v);
+}
+
+void ColumnQuantileSketches::merge(const ColumnQuantileSketches& other) {
+  for (size_t c = 0; c < columns_.size() && c < other.columns_.size(); c++)
+    columns_[c].merge(other.columns_[c]);
+}
+
+std::vector<OutlierFence> ColumnQuantileSketches::fences() const {
+  std::vector<OutlierFence> out(columns_.size());
+  for (size_t c = 0; c < columns_.size(); c++) {
+    if (columns_[c].count() < 4) continue;
+    double q1 = columns_[c].quantile(0.25), q3 = columns_[c].quantile(0.75);
+    double iqr = q3 - q1;
+    out[c] = {true, q1 - 1.5 * iqr, q3 + 1.5 * iqr};
+  }
+  return out;
+}
+
+bool isOutsideFences(const std::vector<std::string>& row, const std::vector<OutlierFence>& fences) {
+  double v;
+  for (size_t c = 0; c < fences.size() && c < row.size(); c++) {
+    if (!fences[c].active || !parseNumericCell(row[c], v)) continue;
+    if (v < fences[c].lower || v > fences[c].upper) return true;
+  }
+  return false;
+}
+
+// --- two-pass streaming detection ----------------------------------------
+
+// Contiguous pieces of `csv` that each start at a record boundary.  Only
+// unquoted text can be cut at any newline; quoted text stays whole.
+static std::vector<std::string_view> recordChunks(std::string_view csv, unsigned int parts) {
+  if (parts <= 1 || csv.find('"') != std::string_view::npos) return {csv};
+  std::vector<std::string_view> chunks;
+  size_t begin = 0;
+  for (unsigned int p = 1; p < parts && begin < csv.size(); p++) {
+    size_t cut = csv.find('\n', std::max(begin, csv.size() * p / parts));
+    if (cut == std::string_view::npos) break;
+    chunks.push_back(csv.substr(begin, cut + 1 - begin));
+    begin = cut + 1;
+  }
+  if (begin < csv.size()) chunks.push_back(csv.substr(begin));
+  return chunks;
+}
+
+RowBitmap detectOutliersStreaming(std::string_view csv, unsigned int threadCount) {
+  std::vector<std::string> row;
+  CsvRecordReader headerReader(csv);
+  if (!headerReader.next(row)) return RowBitmap(0);
+  const size_t columns = row.size();
+
+  auto chunks = recordChunks(csv, workerCount(csv.size(), MIN_BYTES_PER_THREAD, threadCount));
+  const unsigned int threads = static_cast<unsigned int>(chunks.size());
+
+  // pass 1: per-chunk sketches and record counts (chunk 0 skips the header)
+  std::vector<ColumnQuantileSketches> sketches;
+  for (unsigned int t = 0; t < threads; t++) sketches.emplace_back(columns, 0x6b6c6c + 977 * t);
+  std::vector<size_t> records(threads, 0);
+  parallelChunks(chunks.size(), threads, [&](unsigned int, size_t b, size_t e) {
+    std::vector<std::string> r;
+    for (size_t c = b; c < e; c++) {
+      CsvRecordReader reader(chunks[c]);
+      if (c == 0) { reader.next(r); records[c]++; }
+      while (reader.next(r)) {
+        sketches[c].addRow(r);
+        records[c]++;
+      }
+    }
+  });
+  for (unsigned int t = 1; t < threads; t++) sketches[0].merge(sketches[t]);
+  const auto fences = sketches[0].fences();
+
+  // pass 2: flag rows against the fences, by global record index
+  std::vector<size_t> first(threads, 0);
+  for (unsigned int t = 1; t < threads; t++) first[t] = first[t - 1] + records[t - 1];
+  std::vector<std::vector<size_t>> flagged(threads);
+  parallelChunks(chunks.size(), threads, [&](unsigned int, size_t b, size_t e) {
+    std::vector<std::string> r;
+    for (size_t c = b; c < e; c++) {
+      CsvRecordReader reader(chunks[c]);
+      size_t index = first[c];
+      if (c == 0) { reader.next(r); index++; }
+      for (; reader.next(r); index++)
+        if (isOutsideFences(r, fences)) flagged[c].push_back(index);
+    }
+  });
+
+  RowBitmap outliers(first.back() + records.back());
+  for (const auto& rows : flagged)
+    for (size_t i : rows) outliers.set(i);
+  return outliers;
+}
@@ -0,0 +1,83 @@
+#ifndef QUANTILE_SKETCH_H
+#define QUANTILE_SKETCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "bitmap.h"
+
+// --- KLL quantile sketch -------------------------------------------------
+
+// Karnin-Lang-Liberty sketch: a stack of compactors, level h holding items of
+// weight 2^h.  A full level is sorted and every other item (random offset)
+// moves up a level, so memory stays O(k log(n/k)) doubles while rank error
+// stays around 1.7/k of n.  Until the first compaction (k values) every
+// value is kept and quantiles are exact.  Sketches built over
+// disjoint parts of a stream merge into a sketch of the whole.
+class KllSketch {
+public:
+  explicit KllSketch(uint32_t k = 200, uint64_t seed = 0x6b6c6c);
+
+  void update(double value);
+  void merge(const KllSketch& other);
+
+  // Value at rank floor(q * count()) in sorted order (0-based), like
+  // sorted[n / 4] for q = 0.25.  0 for an empty sketch.
+  double quantile(double q) const;
+
+  uint64_t count() const { return count_; }
+  size_t retained() const;
+
+private:
+  size_t capacity(size_t level) const;
+  void compress();
+
+  uint32_t k_;
+  uint64_t count_ = 0;
+  size_t size_ = 0;
+  size_t maxSize_ = 0;
+  std::vector<std::vector<double>> levels_;
+  std::mt19937_64 rng_;
+};
+
+// --- per-column IQR fences -----------------------------------------------
+
+struct OutlierFence {
+  bool active = false;  // the column had at least four numeric cells
+  double lower = 0.0;
+  double upper = 0.0;
+};
+
+// One sketch per column over the numeric cells (parseNumericCell) of the rows
+// fed to it; the first pass of the streaming outlier mode.
+class ColumnQuantileSketches {
+public:
+  explicit ColumnQuantileSketches(size_t columns = 0, uint64_t seed = 0x6b6c6c);
+
+  void addRow(const std::vector<std::string>& row);
+  void merge(const ColumnQuantileSketches& other);
+
+  // Q1 - 1.5*IQR and Q3 + 1.5*IQR per column, as detectOutlierRows computes
+  // them from exact quartiles.
+  std::vector<OutlierFence> fences() const;
+
+private:
+  std::vector<KllSketch> columns_;
+};
+
+bool isOutsideFences(const std::vector<std::string>& row, const std::vector<OutlierFence>& fences);
+
+// Two-pass IQR outlier detection over CSV text without materialising the
+// table: pass one sketches each column, pass two flags rows against the
+// fences.  Memory beyond the input is the sketches plus one bit per row.
+// Unquoted input is split at line boundaries and both passes run on worker
+// threads (threadCount 0 = hardware concurrency) with per-thread sketches
+// merged between them; quoted input, whose records may span lines, is read
+// on one thread.  Returns one bit per record, header first, as
+// detectOutlierRows(parseCSV(csv)) would (within the sketch's rank error).
+RowBitmap detectOutliersStreaming(std::string_view csv, unsigned int threadCount = 0);
+
+#endif
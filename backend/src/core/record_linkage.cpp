@@ -0,0 +1,114 @@
+#include "record_linkage.h"
+#include "blocking_keys.h"
+#include "parallel_for.h"
+#include "string_issue_detectors.h"
+#include "weighted_dedup.h"
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+
+static const size_t LINK_WINDOW = 20;          // candidates from B per row of A
+static const size_t LINK_BLOCK_CAP = 200;      // most B rows scored from one A row's own block
+static const size_t MIN_ROWS_PER_THREAD = 1024;
+
+std::vector<LinkedColumn> linkColumns(const std::vector<std::vector<std::string>>& tableA,
+                                      const std::vector<std::vector<std::string>>& tableB) {
+  std::vector<LinkedColumn> columns;
+  if (tableA.empty() || tableB.empty()) return columns;
+  std::unordered_map<std::string, size_t> byName;
+  for (size_t j = 0; j < tableB[0].size(); j++)
+    byName.emplace(normalizeForComparison(tableB[0][j]), j);
+
+  auto types = detectColumnTypesFull(tableA).types;
+  for (size_t i = 0; i < tableA[0].size(); i++) {
+    auto it = byName.find(normalizeForComparison(tableA[0][i]));
+    if (it == byName.end()) continue;
+    ColumnType t = i < types.size() ? types[i] : ColumnType::GENERIC_TEXT;
+    columns.push_back({i, it->second, t});
+  }
+  return columns;
+}
+
+// Blocking key and prepared cells of each data row, over the linked columns
+// only, in that column order.
+static void prepareTable(const std::vector<std::vector<std::string>>& table,
+                         const std::vector<LinkedColumn>& columns, bool sideA,
+                         const std::vector<ColumnType>& types, unsigned int threadCount,
+                         std::vector<uint64_t>& keys, std::vector<PreparedRow>& prepared) {
+  size_t rows = table.size() > 0 ? table.size() - 1 : 0;
+  keys.assign(rows, 0);
+  prepared.resize(rows);
+  unsigned int threads = workerCount(rows, MIN_ROWS_PER_THREAD, threadCount);
+  parallelChunks(rows, threads, [&](unsigned int, size_t b, size_t e) {
+    std::vector<std::string> projected(columns.size());
+    for (size_t r = b; r < e; r++) {
+      const auto& row = table[r + 1];
+      for (size_t c = 0; c < columns.size(); c++) {
+        size_t src = sideA ? columns[c].columnA : columns[c].columnB;
+        projected[c] = src < row.size() ? row[src] : std::string();
+      }
+      keys[r] = rowBlockingKey(projected, types);
+      prepared[r] = prepareRow(projected, types);
+    }
+  });
+}
+
+LinkageResult linkRecords(const std::vector<std::vector<std::string>>& tableA,
+                          const std::vector<std::vector<std::string>>& tableB,
+                          const std::vector<LinkedColumn>& columns,
+                          double threshold, unsigned int threadCount) {
+  LinkageResult result;
+  result.columns = columns;
+  if (columns.empty() || tableA.size() <= 1 || tableB.size() <= 1) return result;
+
+  std::vector<ColumnType> types;
+  for (const auto& c : columns) types.push_back(c.type);
+  std::vector<uint64_t> keysA, keysB;
+  std::vector<PreparedRow> rowsA, rowsB;
+  prepareTable(tableA, columns, true, types, threadCount, keysA, rowsA);
+  prepareTable(tableB, columns, false, types, threadCount, keysB, rowsB);
+
+  // B sorted by key.  Each A row is compared with the B rows sharing its
+  // key, up to LINK_BLOCK_CAP, and when that block is smaller than
+  // LINK_WINDOW the rest of the window goes to the nearest rows either side
+  std::vector<std::pair<uint64_t, size_t>> sortedB(keysB.size());
+  for (size_t r = 0; r < keysB.size(); r++) sortedB[r] = {keysB[r], r};
+  std::sort(sortedB.begin(), sortedB.end());
+
+  unsigned int threads = workerCount(rowsA.size(), MIN_ROWS_PER_THREAD, threadCount);
+  std::vector<std::vector<RecordMatch>> found(threads);
+  std::vector<size_t> compared(threads, 0);
+  parallelChunks(rowsA.size(), threads, [&](unsigned int t, size_t b, size_t e) {
+    auto score = [&](size_t a, size_t k) {
+      size_t rb = sortedB[k].second;
+      double s = rowSimilarity(rowsA[a], rowsB[rb], types);
+      if (s >= threshold) found[t].push_back({a + 1, rb + 1, s});
+      compared[t]++;
+    };
+    for (size_t a = b; a < e; a++) {
+      auto key = std::make_pair(keysA[a], size_t(0));
+      size_t pos = std::lower_bound(sortedB.begin(), sortedB.end(), key) - sortedB.begin();
+      size_t end = pos;
+      while (end < sortedB.size() && end - pos < LINK_BLOCK_CAP && sortedB[end].first == keysA[a])
+        score(a, end++);
+      // neighbouring keys, alternating below and above the block
+      size_t budget = LINK_WINDOW > end - pos ? LINK_WINDOW - (end - pos) : 0;
+      size_t below = pos, above = end;
+      while (budget > 0 && (below > 0 || above < sortedB.size())) {
+        if (below > 0) { score(a, --below); budget--; }
+        if (budget > 0 && above < sortedB.size()) { score(a, above++); budget--; }
+      }
+    }
+  });
+
+  for (size_t t = 0; t < found.size(); t++) {
+    result.matches.insert(result.matches.end(), found[t].begin(), found[t].end());
+    result.comparisons += compared[t];
+  }
+  std::sort(result.matches.begin(), result.matches.end(), [](const RecordMatch& x, const RecordMatch& y) {
+    if (x.rowA != y.rowA) return x.rowA < y.rowA;
+    if (x.score != y.score) return x.score > y.score;
+    return x.rowB < y.rowB;
+  });
+  return result;
+}
@@ -0,0 +1,48 @@
+#ifndef RECORD_LINKAGE_H
+#define RECORD_LINKAGE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "column_type_detection.h"
+
+// Fuzzy record linkage between two tables, without concatenating them.
+// Columns are paired by header name (compared case- and space-insensitively);
+// unpaired columns are ignored.  Rows of both tables are keyed with
+// rowBlockingKey over the shared columns and table B is sorted by key.  Each
+// row of A is scored with weighted_dedup's rowSimilarity against the B rows
+// with its key (at most 200), topped up to 20 candidates with the nearest
+// keys either side.  Work per row is bounded, so 100k x 100k rows is a few
+// million comparisons rather than 10^10.
+
+struct LinkedColumn {
+  size_t columnA;
+  size_t columnB;
+  ColumnType type;
+};
+
+struct RecordMatch {
+  size_t rowA;   // row index in table A (1 = first data row)
+  size_t rowB;   // row index in table B
+  double score;
+};
+
+struct LinkageResult {
+  std::vector<LinkedColumn> columns;
+  std::vector<RecordMatch> matches;  // by rowA, then descending score
+  size_t comparisons = 0;
+};
+
+// Columns shared by the two headers, typed from table A's data.
+std::vector<LinkedColumn> linkColumns(const std::vector<std::vector<std::string>>& tableA,
+                                      const std::vector<std::vector<std::string>>& tableB);
+
+// Pairs of rows scoring at least `threshold`; both tables start with their
+// header row.  Scoring runs on worker threads (threadCount 0 = hardware
+// concurrency).
+LinkageResult linkRecords(const std::vector<std::vector<std::string>>& tableA,
+                          const std::vector<std::vector<std::string>>& tableB,
+                          const std::vector<LinkedColumn>& columns,
+                          double threshold, unsigned int threadCount = 0);
+
+#endif
@@ -0,0 +1,252 @@
+#include "reference_dictionary.h"
+#include "blocking_keys.h"
+#include "char_class.h"
+#include "csv_parser.h"
+#include "row_hash.h"
+#include <algorithm>
+#include <list>
+#include <map>
+#include <stdexcept>
+
+static const size_t LOOKUP_CACHE_LIMIT = 1 << 16;  // memoised keys per dictionary
+static const size_t FUZZY_MAX_KEY = 64;            // longer cells are not edit-searched
+static const size_t REGISTRY_SIZE = 8;             // dictionaries kept by the registry
+static const int32_t NO_VALUE = -1;
+static const int32_t AMBIGUOUS = -2;
+
+// Combine two candidate ids for one slot: equal ids stay, different ids
+// (or an ambiguous one) make it ambiguous.
+static int32_t mergeValue(int32_t a, int32_t b) {
+  if (a == NO_VALUE) return b;
+  if (b == NO_VALUE || a == b) return a;
+  return AMBIGUOUS;
+}
+
+std::string ReferenceDictionary::fold(std::string_view s) {
+  std::string folded = asciiFold(s);
+  std::string out;
+  out.reserve(folded.size());
+  bool gap = false;
+  for (char c : folded) {
+    if ((charClass(c) & (CC_ALPHA | CC_DIGIT)) || static_cast<unsigned char>(c) >= 0x80) {
+      if (gap && !out.empty()) out += ' ';
+      gap = false;
+      out += c;
+    } else if (c != '.' && c != '\'') {
+      gap = true;  // "U.S.A." -> "usa", "St-Denis" -> "st denis"
+    }
+  }
+  return out;
+}
+
+// --- construction --------------------------------------------------------
+
+ReferenceDictionary::ReferenceDictionary(const std::vector<std::vector<std::string>>& rows) {
+  std::map<std::string, int32_t> canonicalIds;
+  std::map<std::string, int32_t> keys;  // folded key -> canonical id (sorted)
+  for (const auto& row : rows) {
+    if (row.empty() || row[0].empty()) continue;
+    auto inserted = canonicalIds.emplace(row[0], static_cast<int32_t>(canonical_.size()));
+    if (inserted.second) canonical_.push_back(row[0]);
+    int32_t id = inserted.first->second;
+    for (const auto& cell : row) {
+      std::string key = fold(cell);
+      if (key.empty()) continue;
+      auto k = keys.emplace(key, id);
+      if (!k.second) k.first->second = mergeValue(k.first->second, id);
+    }
+  }
+
+  // pointer trie first, then flattened breadth-first into the edge arrays
+  std::vector<std::map<char, uint32_t>> children(1);
+  std::vector<int32_t> values(1, NO_VALUE);
+  for (const auto& kv : keys) {
+    uint32_t node = 0;
+    for (char c : kv.first) {
+      auto it = children[node].find(c);
+      if (it == children[node].end()) {
+        children.emplace_back();
+        values.push_back(NO_VALUE);
+        it = children[node].emplace(c, static_cast<uint32_t>(children.size() - 1)).first;
+      }
+      node = it->second;
+    }
+    values[node] = kv.second;
+  }
+
+  std::vector<uint32_t> order(1, 0), renumber(children.size(), 0);
+  for (size_t i = 0; i < order.size(); i++)
+    for (const auto& edge : children[order[i]]) {
+      renumber[edge.second] = static_cast<uint32_t>(order.size());
+      order.push_back(edge.second);
+    }
+  const size_t nodes = order.size();
+  edgeBegin_.assign(nodes + 1, 0);
+  value_.assign(nodes, NO_VALUE);
+  for (size_t n = 0; n < nodes; n++) {
+    uint32_t old = order[n];
+    value_[n] = values[old];
+    edgeBegin_[n + 1] = edgeBegin_[n] + static_cast<uint32_t>(children[old].size());
+    for (const auto& edge : children[old]) {
+      edgeLabel_.push_back(edge.first);
+      edgeTarget_.push_back(renumber[edge.second]);
+    }
+  }
+
+  // children come after their parent in breadth-first order, so one reverse
+  // sweep settles every subtree
+  prefixValue_ = value_;
+  for (size_t n = nodes; n-- > 0;)
+    for (uint32_t e = edgeBegin_[n]; e < edgeBegin_[n + 1]; e++)
+      prefixValue_[n] = mergeValue(prefixValue_[n], prefixValue_[edgeTarget_[e]]);
+}
+
+// --- lookup --------------------------------------------------------------
+
+ReferenceMatch ReferenceDictionary::lookup(std::string_view cell, int maxEdits) const {
+  std::string key = fold(cell);
+  if (key.empty()) return {};
+  if (maxEdits < 0) maxEdits = key.size() >= 8 ? 2 : key.size() >= 4 ? 1 : 0;
+  maxEdits = std::min(maxEdits, 3);
+
+  std::string cacheKey = key;
+  cacheKey += static_cast<char>('0' + maxEdits);
+  {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    auto it = cache_.find(cacheKey);
+    if (it != cache_.end()) return it->second;
+  }
+  ReferenceMatch match = search(key, maxEdits);
+  std::lock_guard<std::mutex> lock(cacheMutex_);
+  if (cache_.size() >= LOOKUP_CACHE_LIMIT) cache_.clear();
+  cache_.emplace(std::move(cacheKey), match);
+  return match;
+}
+
+ReferenceMatch ReferenceDictionary::search(const std::string& key, int maxEdits) const {
+  // exact, or the deepest node the key reaches
+  uint32_t node = 0;
+  size_t depth = 0;
+  for (; depth < key.size(); depth++) {
+    uint32_t b = edgeBegin_[node], e = edgeBegin_[node + 1];
+    auto it = std::lower_bound(edgeLabel_.begin() + b, edgeLabel_.begin() + e, key[depth]);
+    if (it == edgeLabel_.begin() + e || *it != key[depth]) break;
+    node = edgeTarget_[static_cast<size_t>(it - edgeLabel_.begin())];
+  }
+  if (depth == key.size()) {
+    if (value_[node] >= 0) return {ReferenceMatchKind::EXACT, value_[node], 0};
+    if (key.size() >= MIN_PREFIX_LENGTH && prefixValue_[node] >= 0)
+      return {ReferenceMatchKind::PREFIX, prefixValue_[node], 0};
+  }
+  if (maxEdits == 0 || key.size() > FUZZY_MAX_KEY) return {};
+  return fuzzy(key, maxEdits);
+}
+
+// Depth-first over the trie; rows[d] is the edit-distance row after the d
+// characters on the path to `node`.  Recursion depth is bounded by the key
+// length plus maxEdits.
+void ReferenceDictionary::descend(uint32_t node, size_t depth, FuzzySearch& s) const {
+  const size_t n = s.key.size();
+  if (depth + 1 >= s.rows.size()) return;
+  const std::vector<int>& prev = s.rows[depth];
+  std::vector<int>& cur = s.rows[depth + 1];
+  for (uint32_t e = edgeBegin_[node]; e < edgeBegin_[node + 1]; e++) {
+    const char c = edgeLabel_[e];
+    cur[0] = static_cast<int>(depth + 1);
+    int rowMin = cur[0];
+    for (size_t j = 1; j <= n; j++) {
+      int sub = prev[j - 1] + (s.key[j - 1] == c ? 0 : 1);
+      cur[j] = std::min({prev[j] + 1, cur[j - 1] + 1, sub});
+      rowMin = std::min(rowMin, cur[j]);
+    }
+    uint32_t child = edgeTarget_[e];
+    if (value_[child] != NO_VALUE && cur[n] <= s.maxEdits) {
+      if (cur[n] < s.best) { s.best = cur[n]; s.bestValue = value_[child]; }
+      else if (cur[n] == s.best) s.bestValue = mergeValue(s.bestValue, value_[child]);
+    }
+    // no completion of this path can come back under the limit
+    if (rowMin <= s.maxEdits) descend(child, depth + 1, s);
+  }
+}
+
+ReferenceMatch ReferenceDictionary::fuzzy(const std::string& key, int maxEdits) const {
+  const size_t n = key.size();
+  FuzzySearch s{key, maxEdits, maxEdits + 1, NO_VALUE,
+                std::vector<std::vector<int>>(n + static_cast<size_t>(maxEdits) + 2, std::vector<int>(n + 1))};
+  for (size_t j = 0; j <= n; j++) s.rows[0][j] = static_cast<int>(j);
+  descend(0, 0, s);
+  if (s.bestValue < 0) return {};
+  return {ReferenceMatchKind::FUZZY, s.bestValue, s.best};
+}
+
+// --- shared registry -----------------------------------------------------
+
+namespace {
+struct RegistryEntry {
+  uint64_t hash;
+  std::string source;
+  std::shared_ptr<const ReferenceDictionary> dictionary;
+};
+}
+
+static std::mutex registryMutex;
+static std::list<RegistryEntry> registry;  // most recently used first
+
+std::shared_ptr<const ReferenceDictionary> sharedReferenceDictionary(const std::string& referenceCsv) {
+  const uint64_t hash = hashCell(referenceCsv);
+  {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (auto it = registry.begin(); it != registry.end(); ++it) {
+      if (it->hash != hash || it->source != referenceCsv) continue;
+      registry.splice(registry.begin(), registry, it);
+      return registry.front().dictionary;
+    }
+  }
+  // built outside the lock; two requests racing on a new dictionary may both
+  // build it, and the later one is simply dropped
+  auto rows = parseCSV(referenceCsv);
+  if (!rows.empty()) rows.erase(rows.begin());  // header
+  auto built = std::make_shared<const ReferenceDictionary>(rows);
+  std::lock_guard<std::mutex> lock(registryMutex);
+  for (const auto& entry : registry)
+    if (entry.hash == hash && entry.source == referenceCsv) return entry.dictionary;
+  registry.push_front({hash, referenceCsv, built});
+  if (registry.size() > REGISTRY_SIZE) registry.pop_back();
+  return built;
+}
+
+// --- column standardisation ----------------------------------------------
+
+ReferenceStandardiseResult standardiseToReference(std::vector<std::vector<std::string>> data,
+                                                  const std::string& column,
+                                                  const ReferenceDictionary& dictionary,
+                                                  int maxEdits) {
+  ReferenceStandardiseResult result;
+  if (data.empty()) return result;
+  auto col = std::find(data[0].begin(), data[0].end(), column);
+  if (col == data[0].end()) throw std::invalid_argument("standardiseToReference: no column " + column);
+  const size_t c = static_cast<size_t>(col - data[0].begin());
+
+  // a column repeats a handful of spellings: one lookup per distinct value
+  std::unordered_map<std::string, ReferenceMatch> seen;
+  for (size_t r = 1; r < data.size(); r++) {
+    if (c >= data[r].size() || data[r][c].empty()) continue;
+    std::string& cell = data[r][c];
+    auto it = seen.find(cell);
+    if (it == seen.end()) it = seen.emplace(cell, dictionary.lookup(cell, maxEdits)).first;
+    const ReferenceMatch& m = it->second;
+    switch (m.kind) {
+      case ReferenceMatchKind::EXACT: result.exactMatches++; break;
+      case ReferenceMatchKind::PREFIX: result.prefixMatches++; break;
+      case ReferenceMatchKind::FUZZY: result.fuzzyMatches++; break;
+      case ReferenceMatchKind::NONE: result.unmatched++; continue;
+    }
+    const std::string& canonical = dictionary.canonical(m.canonical);
+    if (cell != canonical) {
+      cell = canonical;
+      result.cellsChanged++;
+    }
+  }
+  result.data = std::move(data);
+  return result;
+}
@@ -0,0 +1,108 @@
+#ifndef REFERENCE_DICTIONARY_H
+#define REFERENCE_DICTIONARY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Reference-list standardisation: map messy cell values onto the canonical
+// spellings of a reference list (countries, states, cities, ...) with one
+// index instead of one find/replace rule per variant.
+//
+// Every canonical value and its variants are folded (lower-case ASCII,
+// Latin-1 accents removed, punctuation dropped, whitespace collapsed) and
+// stored in a compact trie: flat arrays of nodes and edges, built once and
+// read-only afterwards.  A cell is looked up
+//   1. exactly,
+//   2. as a prefix shared by the keys of only one canonical value
+//      ("calif" -> California), for prefixes of MIN_PREFIX_LENGTH or more,
+//   3. within `maxEdits` Levenshtein edits, by walking the trie with one
+//      edit-distance row per node (a Levenshtein automaton run over the
+//      trie): subtrees whose best row entry exceeds the limit are skipped.
+// Lookups that tie between two canonical values are ambiguous and match
+// nothing.
+
+static const size_t MIN_PREFIX_LENGTH = 3;
+
+enum class ReferenceMatchKind { NONE, EXACT, PREFIX, FUZZY };
+
+struct ReferenceMatch {
+  ReferenceMatchKind kind = ReferenceMatchKind::NONE;
+  int32_t canonical = -1;  // index into ReferenceDictionary::canonical()
+  int distance = 0;        // edits, for FUZZY
+};
+
+class ReferenceDictionary {
+public:
+  // rows: canonical value first, then any number of variants; empty cells
+  // are ignored.  A variant listed under two canonical values is ambiguous
+  // and dropped.
+  explicit ReferenceDictionary(const std::vector<std::vector<std::string>>& rows);
+
+  // maxEdits < 0 picks by key length: 0 below 4 characters, 1 below 8,
+  // 2 from 8.  Results are memoised per folded key (bounded, thread-safe),
+  // so repeated values across requests cost one hash lookup.
+  ReferenceMatch lookup(std::string_view cell, int maxEdits = -1) const;
+
+  const std::string& canonical(int32_t id) const { return canonical_[static_cast<size_t>(id)]; }
+  size_t size() const { return canonical_.size(); }
+  size_t nodeCount() const { return value_.size(); }
+
+  static std::string fold(std::string_view s);
+
+private:
+  struct FuzzySearch {
+    const std::string& key;
+    int maxEdits;
+    int best;
+    int32_t bestValue;
+    std::vector<std::vector<int>> rows;
+  };
+
+  ReferenceMatch search(const std::string& key, int maxEdits) const;
+  ReferenceMatch fuzzy(const std::string& key, int maxEdits) const;
+  void descend(uint32_t node, size_t depth, FuzzySearch& s) const;
+
+  std::vector<std::string> canonical_;
+  // trie, node 0 is the root; node n's edges are [edgeBegin_[n], edgeBegin_[n+1])
+  // sorted by label
+  std::vector<uint32_t> edgeBegin_;
+  std::vector<char> edgeLabel_;
+  std::vector<uint32_t> edgeTarget_;
+  std::vector<int32_t> value_;        // canonical id at this node, -1 none, -2 ambiguous
+  std::vector<int32_t> prefixValue_;  // only canonical id below this node, else -1 / -2
+
+  mutable std::mutex cacheMutex_;
+  mutable std::unordered_map<std::string, ReferenceMatch> cache_;
+};
+
+// Dictionary from reference CSV text: a header row, then one row per
+// canonical value (canonical first, variants after).
+//
+// Dictionaries built from identical reference text are shared: the first
+// request builds the trie, later ones (from any client) reuse it.  The
+// registry keeps the most recently used few.
+std::shared_ptr<const ReferenceDictionary> sharedReferenceDictionary(const std::string& referenceCsv);
+
+struct ReferenceStandardiseResult {
+  std::vector<std::vector<std::string>> data;
+  int exactMatches = 0;
+  int prefixMatches = 0;
+  int fuzzyMatches = 0;
+  int unmatched = 0;     // non-empty cells with no match
+  int cellsChanged = 0;
+};
+
+// Rewrites `column` (by header name) of `data` to canonical values.  Throws
+// std::invalid_argument if the column does not exist.
+ReferenceStandardiseResult standardiseToReference(std::vector<std::vector<std::string>> data,
+                                                  const std::string& column,
+                                                  const ReferenceDictionary& dictionary,
+                                                  int maxEdits = -1);
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef ROW_HASH_H
+#define ROW_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// --- row hashing ---------------------------------------------------------
+
+// 64-bit hashes over rows of cells, consumed eight bytes at a time.  Each
+// cell's length is folded into its hash, so ["ab","c"] and ["a","bc"] hash
+// differently.  Not stable across builds or platforms (byte order): use it
+// for in-memory tables, never persist it.
+
+inline uint64_t hashMix(uint64_t h) {
+  // murmur3 fmix64 finaliser
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+inline uint64_t loadWord(const char* p) {
+  uint64_t w;
+  std::memcpy(&w, p, sizeof(w));
+  return w;
+}
+
+inline uint64_t hashBytes(const char* p, size_t n, uint64_t seed = 0) {
+  const uint64_t K = 0x9e3779b97f4a7c15ULL;
+  uint64_t h = seed ^ (n * K);
+  if (n <= 8) {
+    // short cells (codes, flags, numbers) take a single partial load
+    uint64_t w = 0;
+    std::memcpy(&w, p, n);
+    return hashMix(h ^ w);
+  }
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) h = (h ^ hashMix(loadWord(p + i))) * K;
+  // tail: the last eight bytes, overlapping what was already consumed
+  if (i < n) h = (h ^ hashMix(loadWord(p + n - 8))) * K;
+  return hashMix(h);
+}
+
+inline uint64_t hashCell(const std::string& cell, uint64_t seed = 0) {
+  return hashBytes(cell.data(), cell.size(), seed);
+}
+
+inline uint64_t hashRow(const std::vector<std::string>& row) {
+  uint64_t h = 0x243f6a8885a308d3ULL ^ row.size();
+  for (const auto& cell : row) h = hashCell(cell, h);
+  return h;
+}
+
+// --- flat row-index table ------------------------------------------------
+
+// Open-addressing set of row indices with linear probing.  The table holds
+// only 32-bit indices; the caller owns a hash per row (`hashes[index]`) and an
+// equality test, so the rows themselves are never copied.  Probes compare the
+// stored hash first and call `eq` only on a full 64-bit match.
+class RowIndexTable {
+public:
+  explicit RowIndexTable(const std::vector<uint64_t>& hashes, size_t expected = 0)
+      : hashes_(hashes) {
+    size_t cap = 16;
+    while (cap < expected * 2) cap <<= 1;  // keep the load factor at or below 1/2
+    slots_.assign(cap, EMPTY);
+  }
+
+  // If a row equal to `index` is already present return its index, otherwise
+  // insert `index` and return it.
+  template <typename Eq>
+  size_t findOrInsert(size_t index, Eq&& eq) {
+    if (index >= EMPTY) throw std::length_error("RowIndexTable: too many rows");
+    if ((size_ + 1) * 2 > slots_.size()) grow();
+    const uint64_t h = hashes_[index];
+    size_t mask = slots_.size() - 1;
+    for (size_t s = h & mask;; s = (s + 1) & mask) {
+      uint32_t cur = slots_[s];
+      if (cur == EMPTY) {
+        slots_[s] = static_cast<uint32_t>(index);
+        size_++;
+        return index;
+      }
+      if (hashes_[cur] == h && eq(static_cast<size_t>(cur), index)) return cur;
+    }
+  }
+
+  size_t size() const { return size_; }
+
+private:
+  static constexpr uint32_t EMPTY = 0xFFFFFFFFu;
+
+  void grow() {
+    std::vector<uint32_t> old;
+    old.swap(slots_);
+    slots_.assign(old.size() * 2, EMPTY);
+    size_t mask = slots_.size() - 1;
+    for (uint32_t cur : old) {
+      if (cur == EMPTY) continue;
+      size_t s = hashes_[cur] & mask;
+      while (slots_[s] != EMPTY) s = (s + 1) & mask;
+      slots_[s] = cur;
+    }
+  }
+
+  const std::vector<uint64_t>& hashes_;
+  std::vector<uint32_t> slots_;
+  size_t size_ = 0;
+};
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <string>
+
+// SHA-256 (FIPS 180-4) of `data` as 64 lowercase hex digits.  Used where a
+// client secret must map to a name the server can store without keeping the
+// secret itself; not meant for bulk hashing (row_hash.h is far faster).
+std::string sha256Hex(const std::string& data);
+
+#endif
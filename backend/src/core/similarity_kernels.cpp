@@ -0,0 +1,244 @@
+#include "similarity_kernels.h"
+#include "ascii_kernels.h"
+#include "char_class.h"
+#include "utf8.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SIMILARITY_SSE2 1
+#endif
+
+// Scratch array on the stack for small inputs, on the heap beyond that.
+template <typename T, size_t N>
+class ScratchBuffer {
+public:
+  ScratchBuffer(size_t n, T fill) {
+    if (n > N) { heap_.assign(n, fill); data_ = heap_.data(); }
+    else { std::fill(stack_, stack_ + n, fill); data_ = stack_; }
+  }
+  T* data() { return data_; }
+  T& operator[](size_t i) { return data_[i]; }
+
+private:
+  T stack_[N];
+  std::vector<T> heap_;
+  T* data_;
+};
+
+// --- edit distance ---------------------------------------------------------
+
+template <typename T>
+static double levenshteinRatioOf(const T* a, size_t m, const T* b, size_t n) {
+  if (m < n) { std::swap(a, b); std::swap(m, n); }  // b is the shorter: one row of n+1
+  ScratchBuffer<uint32_t, SMALL_KERNEL_LENGTH + 1> row(n + 1, 0);
+  for (size_t j = 0; j <= n; j++) row[j] = static_cast<uint32_t>(j);
+  for (size_t i = 1; i <= m; i++) {
+    uint32_t diag = row[0];
+    row[0] = static_cast<uint32_t>(i);
+    for (size_t j = 1; j <= n; j++) {
+      uint32_t up = row[j];
+      uint32_t best = a[i - 1] == b[j - 1] ? diag : 1 + std::min({diag, up, row[j - 1]});
+      diag = up;
+      row[j] = best;
+    }
+  }
+  return 1.0 - static_cast<double>(row[n]) / static_cast<double>(m);
+}
+
+double levenshteinRatio(std::string_view a, std::string_view b) {
+  if (a == b) return 1.0;
+  if (isAscii(a.data(), a.size()) && isAscii(b.data(), b.size()))
+    return levenshteinRatioOf(a.data(), a.size(), b.data(), b.size());
+  std::vector<char32_t> ca, cb;
+  decodeUtf8(a, ca);
+  decodeUtf8(b, cb);
+  return levenshteinRatioOf(ca.data(), ca.size(), cb.data(), cb.size());
+}
+
+// --- Jaro-Winkler ----------------------------------------------------------
+
+// First j in [lo, hi) with b[j] == c and taken[j] == 0, or hi if none.
+static size_t findUnmatched(const char* b, const uint8_t* taken, size_t lo, size_t hi, char c) {
+  size_t j = lo;
+#ifdef SIMILARITY_SSE2
+  const __m128i needle = _mm_set1_epi8(c);
+  const __m128i zero = _mm_setzero_si128();
+  for (; j + 16 <= hi; j += 16) {
+    __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j)), needle);
+    __m128i open = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(taken + j)), zero);
+    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(eq, open)));
+    if (mask) {
+      while (!(mask & 1u)) { mask >>= 1; j++; }
+      return j;
+    }
+  }
+#endif
+  for (; j < hi; j++)
+    if (b[j] == c && !taken[j]) return j;
+  return hi;
+}
+
+double jaroWinkler(std::string_view a, std::string_view b) {
+  if (a == b) return 1.0;
+  if (a.empty() || b.empty()) return 0.0;
+  const size_t window = std::max(a.size(), b.size()) / 2 > 0 ? std::max(a.size(), b.size()) / 2 - 1 : 0;
+  ScratchBuffer<uint8_t, SMALL_KERNEL_LENGTH> aTaken(a.size(), 0);
+  ScratchBuffer<uint8_t, SMALL_KERNEL_LENGTH> bTaken(b.size(), 0);
+
+  size_t matches = 0;
+  for (size_t i = 0; i < a.size(); i++) {
+    size_t lo = i > window ? i - window : 0;
+    size_t hi = std::min(i + window + 1, b.size());
+    if (lo >= hi) continue;
+    size_t j = findUnmatched(b.data(), bTaken.data(), lo, hi, a[i]);
+    if (j < hi) {
+      aTaken[i] = 1;
+      bTaken[j] = 0xFF;
+      matches++;
+    }
+  }
+  if (matches == 0) return 0.0;
+
+  size_t halfTranspositions = 0;
+  for (size_t i = 0, j = 0; i < a.size(); i++) {
+    if (!aTaken[i]) continue;
+    while (!bTaken[j]) j++;
+    if (a[i] != b[j]) halfTranspositions++;
+    j++;
+  }
+  const double m = static_cast<double>(matches);
+  double jaro = (m / a.size() + m / b.size() + (m - halfTranspositions / 2.0) / m) / 3.0;
+  if (jaro <= 0.7) return jaro;
+
+  size_t prefix = 0;
+  while (prefix < 4 && prefix < a.size() && prefix < b.size() && a[prefix] == b[prefix]) prefix++;
+  return jaro + prefix * 0.1 * (1.0 - jaro);
+}
+
+// --- token ratios ----------------------------------------------------------
+
+std::string sortedTokens(std::string_view s) {
+  std::string folded;
+  if (!isAscii(s.data(), s.size())) {
+    folded = utf8FoldCase(s);
+    s = folded;
+  }
+  std::vector<std::string> tokens;
+  std::string cur;
+  for (char c : s) {
+    if ((charClass(c) & (CC_ALPHA | CC_DIGIT)) || static_cast<unsigned char>(c) >= 0x80) {
+      cur += lowerChar(c);
+    } else if (!cur.empty()) {
+      tokens.push_back(std::move(cur));
+      cur.clear();
+    }
+  }
+  if (!cur.empty()) tokens.push_back(std::move(cur));
+  std::sort(tokens.begin(), tokens.end());
+  std::string out;
+  for (const auto& t : tokens) {
+    if (!out.empty()) out += ' ';
+    out += t;
+  }
+  return out;
+}
+
+double tokenSortRatio(std::string_view sortedA, std::string_view sortedB) {
+  return levenshteinRatio(sortedA, sortedB);
+}
+
+// Next space-delimited token of `s` starting at `pos`; advances `pos`.
+static std::string_view nextToken(std::string_view s, size_t& pos) {
+  size_t end = s.find(' ', pos);
+  if (end == std::string_view::npos) end = s.size();
+  std::string_view tok = s.substr(pos, end - pos);
+  pos = end + 1;
+  return tok;
+}
+
+double tokenSetRatio(std::string_view sortedA, std::string_view sortedB) {
+  if (sortedA == sortedB) return 1.0;
+  if (sortedA.empty() || sortedB.empty()) return 0.0;
+  // merge-walk the sorted token lists into shared / only-A / only-B strings,
+  // each still sorted and space-joined
+  const size_t cap = sortedA.size() + sortedB.size() + 2;
+  ScratchBuffer<char, 2 * SMALL_KERNEL_LENGTH> shared(cap, 0), onlyA(cap, 0), onlyB(cap, 0);
+  size_t ns = 0, na = 0, nb = 0;
+  auto append = [](ScratchBuffer<char, 2 * SMALL_KERNEL_LENGTH>& buf, size_t& len, std::string_view tok) {
+    if (len > 0) buf[len++] = ' ';
+    std::copy(tok.begin(), tok.end(), buf.data() + len);
+    len += tok.size();
+  };
+  size_t pa = 0, pb = 0;
+  std::string_view ta = nextToken(sortedA, pa), tb = nextToken(sortedB, pb);
+  bool moreA = true, moreB = true;
+  while (moreA || moreB) {
+    if (moreA && (!moreB || ta < tb)) {
+      append(onlyA, na, ta);
+      moreA = pa <= sortedA.size();
+      if (moreA) ta = nextToken(sortedA, pa);
+    } else if (moreB && (!moreA || tb < ta)) {
+      append(onlyB, nb, tb);
+      moreB = pb <= sortedB.size();
+      if (moreB) tb = nextToken(sortedB, pb);
+    } else {
+      append(shared, ns, ta);
+      moreA = pa <= sortedA.size();
+      if (moreA) ta = nextToken(sortedA, pa);
+      moreB = pb <= sortedB.size();
+      if (moreB) tb = nextToken(sortedB, pb);
+    }
+  }
+  if (ns == 0) return levenshteinRatio(sortedA, sortedB);
+
+  // t1 = shared + onlyA, t2 = shared + onlyB
+  std::string_view t0(shared.data(), ns);
+  ScratchBuffer<char, 2 * SMALL_KERNEL_LENGTH> t1(cap, 0), t2(cap, 0);
+  size_t n1 = 0, n2 = 0;
+  append(t1, n1, t0);
+  if (na) append(t1, n1, std::string_view(onlyA.data(), na));
+  append(t2, n2, t0);
+  if (nb) append(t2, n2, std::string_view(onlyB.data(), nb));
+  std::string_view s1(t1.data(), n1), s2(t2.data(), n2);
+  return std::max({levenshteinRatio(t0, s1), levenshteinRatio(t0, s2), levenshteinRatio(s1, s2)});
+}
+
+// --- q-gram signatures -----------------------------------------------------
+
+QGramSignature qgramSignature(std::string_view s) {
+  QGramSignature sig;
+  // rolling window over the folded text: case-folded, inner whitespace runs
+  // as one space, leading and trailing whitespace dropped
+  uint32_t window = 0;
+  size_t seen = 0;
+  bool pendingSpace = false;
+  auto push = [&](char f) {
+    window = ((window << 8) | static_cast<unsigned char>(f)) & 0xFFFFFFu;
+    if (++seen >= 3) {
+      uint32_t h = window * 2654435761u;  // Knuth multiplicative hash
+      sig.set((h >> 16) % sig.size());
+    }
+  };
+  for (char c : s) {
+    if (charClass(c) & CC_CSPACE) {
+      pendingSpace = seen > 0;
+      continue;
+    }
+    if (pendingSpace) { push(' '); pendingSpace = false; }
+    push(lowerChar(c));
+  }
+  if (seen > 0 && seen < 3) {
+    // texts shorter than one trigram still get a signature of themselves
+    uint32_t h = (window | 0x1000000u) * 2654435761u;
+    sig.set((h >> 16) % sig.size());
+  }
+  return sig;
+}
+
+double qgramJaccard(const QGramSignature& a, const QGramSignature& b) {
+  size_t uni = (a | b).count();
+  if (uni == 0) return 1.0;
+  return static_cast<double>((a & b).count()) / static_cast<double>(uni);
+}
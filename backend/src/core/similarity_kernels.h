@@ -0,0 +1,50 @@
+#ifndef SIMILARITY_KERNELS_H
+#define SIMILARITY_KERNELS_H
+
+#include <bitset>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// String similarity kernels in [0, 1] for per-type cell comparison.  None of
+// them allocate for cells up to SMALL_KERNEL_LENGTH bytes (longer inputs fall
+// back to a heap buffer).  Callers pass inputs already in comparison form
+// (case-folded etc.).  Levenshtein counts UTF-8 code points; the other
+// kernels compare bytes.
+
+static const size_t SMALL_KERNEL_LENGTH = 256;
+
+// 1 - levenshtein / max length, with a two-row DP, both in code points.
+// Non-ASCII inputs are decoded first (to the heap).
+double levenshteinRatio(std::string_view a, std::string_view b);
+
+// Jaro-Winkler (prefix scale 0.1, prefix up to 4, boost above 0.7).  The
+// match-window scan compares 16 bytes at a time where SSE2 is available.
+double jaroWinkler(std::string_view a, std::string_view b);
+
+// --- token ratios ----------------------------------------------------------
+
+// Pre-tokenised form for the token ratios: case-folded alphanumeric tokens,
+// sorted and joined with single spaces.  Build once per cell, compare many
+// times.
+std::string sortedTokens(std::string_view s);
+
+// Order-insensitive: "Smith John" and "john smith" score 1.
+double tokenSortRatio(std::string_view sortedA, std::string_view sortedB);
+
+// Best ratio among the shared tokens alone and the shared tokens plus either
+// side's remainder, so a name that is a token subset of another scores 1.
+double tokenSetRatio(std::string_view sortedA, std::string_view sortedB);
+
+// --- q-gram signatures -----------------------------------------------------
+
+// Character trigrams of the lower-cased, whitespace-collapsed text, hashed
+// into a fixed bitset.  Jaccard over two signatures is a couple of hundred
+// word operations regardless of text length; estimates drift upwards once a
+// text has more than a few hundred distinct trigrams and the bits saturate.
+using QGramSignature = std::bitset<2048>;
+
+QGramSignature qgramSignature(std::string_view s);
+double qgramJaccard(const QGramSignature& a, const QGramSignature& b);
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef SPILL_FILE_H
+#define SPILL_FILE_H
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Most spill files a merge reads at once; with more, merging runs in passes
+// so the open descriptors stay bounded however many files were spilled.
+static const size_t MAX_MERGE_FAN_IN = 64;
+
+// Private (0700, via mkdtemp) directory for one out-of-core run's spill
+// files, removed with everything in it on destruction, including when the
+// run fails.  `name` prefixes the directory ("toolkit-dedup-XXXXXX").
+class SpillDirectory {
+public:
+  SpillDirectory(const std::string& base, const std::string& name) {
+    std::filesystem::path root = base.empty() ? std::filesystem::temp_directory_path()
+                                              : std::filesystem::path(base);
+    std::string tmpl = (root / (name + "-XXXXXX")).string();
+    std::vector<char> buf(tmpl.begin(), tmpl.end());
+    buf.push_back('\0');
+    if (!mkdtemp(buf.data()))
+      throw std::runtime_error(name + ": cannot create spill directory under " + root.string());
+    path_ = buf.data();
+  }
+  ~SpillDirectory() {
+    std::error_code ec;
+    std::filesystem::remove_all(path_, ec);
+  }
+  SpillDirectory(const SpillDirectory&) = delete;
+  SpillDirectory& operator=(const SpillDirectory&) = delete;
+
+  std::string newFile(const std::string& prefix) {
+    return (path_ / (prefix + std::to_string(next_++))).string();
+  }
+
+private:
+  std::filesystem::path path_;
+  size_t next_ = 0;
+};
+
+inline std::unique_ptr<std::ofstream> openSpill(const std::string& path) {
+  auto os = std::make_unique<std::ofstream>(path, std::ios::binary | std::ios::trunc);
+  if (!*os) throw std::runtime_error("cannot open spill file " + path);
+  return os;
+}
+
+inline void closeSpill(std::ofstream& os, const std::string& path) {
+  os.close();
+  if (!os) throw std::runtime_error("cannot write spill file " + path);
+}
+
+#endif
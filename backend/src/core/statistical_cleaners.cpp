@@ -1,31 +1,102 @@
 #include "structural_cleaners.h"
 #include "string_issue_detectors.h"
-#include <set>
+#include "parallel_for.h"
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
 
 std::vector<std::vector<std::string>> removeOutliers(
-  const std::vector<std::vector<std::string>>& data){
-  std::vector<int> outlierRows=detectOutliers(data);
-  std::set<int> outlierSet(outlierRows.begin(),outlierRows.end());
+  const std::vector<std::vector<std::string>>& data, const OutlierOptions& options){
+  RowBitmap outliers=detectOutlierRows(data,options);
   std::vector<std::vector<std::string>> result;
+  result.reserve(data.size()-outliers.count());
   for(size_t i=0;i<data.size();i++){
-    if(outlierSet.find(static_cast<int>(i))==outlierSet.end()) result.push_back(data[i]);
+    if(!outliers.test(i)) result.push_back(data[i]);
   }
   return result;
 }
 
-std::vector<std::vector<std::string>> fuzzyDeduplicateRows(
-  const std::vector<std::vector<std::string>>& data, double threshold){
+static std::vector<std::vector<std::string>> keepUnmerged(
+  const std::vector<std::vector<std::string>>& data, const std::vector<bool>& merged){
   std::vector<std::vector<std::string>> result;
+  for(size_t i=0;i<data.size();i++) if(!merged[i]) result.push_back(data[i]);
+  return result;
+}
+
+// All pairs, in row order: each surviving row absorbs every later surviving
+// row it matches.
+static std::vector<std::vector<std::string>> fuzzyDeduplicateExhaustive(
+  const std::vector<std::vector<std::string>>& data, double threshold){
   std::vector<bool> merged(data.size(),false);
   for(size_t i=0;i<data.size();i++){
     if(merged[i]) continue;
-    std::vector<std::string> combined=data[i];
     for(size_t j=i+1;j<data.size();j++){
       if(merged[j]) continue;
       double sim=calculateRowSimilarity(data[i],data[j]);
       if(sim>=threshold) merged[j]=true;
     }
-    result.push_back(combined);
   }
-  return result;
+  return keepUnmerged(data,merged);
+}
+
+// Sort key: cells lower-cased with spaces removed (as calculateSimilarity
+// compares them), joined in the given column order.
+static std::string fuzzySortKey(const std::vector<std::string>& row, bool reversed){
+  std::string key;
+  for(size_t k=0;k<row.size();k++){
+    if(k>0) key+='\x1f';
+    key+=normalizeForComparison(row[reversed?row.size()-1-k:k]);
+  }
+  return key;
+}
+
+// Two-pass sorted neighbourhood: data rows are sorted by their key in column
+// order and again in reverse column order (so an edit in the leading column
+// does not push a near-duplicate out of the window), and only rows within
+// FUZZY_WINDOW of each other in either order become candidate pairs.
+// Candidates are scored in parallel, then resolved in row order exactly as the
+// exhaustive pass does. The header row is never merged.
+static std::vector<std::vector<std::string>> fuzzyDeduplicateBlocked(
+  const std::vector<std::vector<std::string>>& data, double threshold, unsigned int threadCount){
+  const size_t FUZZY_WINDOW=20;
+  const size_t MIN_PAIRS_PER_THREAD=2048;
+  if(data.size()<=2) return data;
+  size_t n=data.size();
+
+  std::vector<std::pair<uint32_t,uint32_t>> pairs;
+  for(bool reversed:{false,true}){
+    std::vector<std::string> keys(n);
+    for(size_t i=1;i<n;i++) keys[i]=fuzzySortKey(data[i],reversed);
+    std::vector<uint32_t> order(n-1);
+    std::iota(order.begin(),order.end(),1u);
+    std::stable_sort(order.begin(),order.end(),[&](uint32_t a,uint32_t b){ return keys[a]<keys[b]; });
+    for(size_t i=0;i<order.size();i++){
+      size_t end=std::min(order.size(),i+FUZZY_WINDOW);
+      for(size_t j=i+1;j<end;j++)
+        pairs.push_back({std::min(order[i],order[j]),std::max(order[i],order[j])});
+    }
+  }
+  std::sort(pairs.begin(),pairs.end());
+  pairs.erase(std::unique(pairs.begin(),pairs.end()),pairs.end());
+
+  std::vector<uint8_t> match(pairs.size(),0);
+  unsigned int threads=workerCount(pairs.size(),MIN_PAIRS_PER_THREAD,threadCount);
+  parallelChunks(pairs.size(),threads,[&](unsigned int,size_t b,size_t e){
+    for(size_t k=b;k<e;k++)
+      match[k]=calculateRowSimilarity(data[pairs[k].first],data[pairs[k].second])>=threshold;
+  });
+
+  // pairs are sorted by (i, j), so walking them replays the exhaustive order
+  std::vector<bool> merged(n,false);
+  for(size_t k=0;k<pairs.size();k++){
+    if(match[k] && !merged[pairs[k].first]) merged[pairs[k].second]=true;
+  }
+  return keepUnmerged(data,merged);
+}
+
+std::vector<std::vector<std::string>> fuzzyDeduplicateRows(
+  const std::vector<std::vector<std::string>>& data, double threshold,
+  FuzzyDedupMode mode, unsigned int threadCount){
+  if(mode==FuzzyDedupMode::EXHAUSTIVE) return fuzzyDeduplicateExhaustive(data,threshold);
+  return fuzzyDeduplicateBlocked(data,threshold,threadCount);
 }
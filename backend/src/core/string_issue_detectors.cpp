@@ -1,47 +1,103 @@
 #include "string_issue_detectors.h"
+#include "ascii_kernels.h"
+#include "char_class.h"
+#include "utf8.h"
+#include "row_hash.h"
+#include "parallel_for.h"
 #include <algorithm>
-#include <set>
 
-int levenshteinDistance(const std::string& s1, const std::string& s2){
-  size_t m=s1.length();
-  size_t n=s2.length();
-  std::vector<std::vector<int>> dp(m+1,std::vector<int>(n+1,0));
-  for(size_t i=0;i<=m;++i) dp[i][0]=static_cast<int>(i);
-  for(size_t j=0;j<=n;++j) dp[0][j]=static_cast<int>(j);
+template<typename T>
+static int editDistance(const T* a, size_t m, const T* b, size_t n){
+  std::vector<int> row(n+1);
+  for(size_t j=0;j<=n;++j) row[j]=static_cast<int>(j);
   for(size_t i=1;i<=m;++i){
+    int diag=row[0];
+    row[0]=static_cast<int>(i);
     for(size_t j=1;j<=n;++j){
-      if(s1[i-1]==s2[j-1]) dp[i][j]=dp[i-1][j-1];
-      else dp[i][j]=1+std::min({dp[i-1][j],dp[i][j-1],dp[i-1][j-1]});
+      int up=row[j];
+      row[j]=a[i-1]==b[j-1]?diag:1+std::min({up,row[j-1],diag});
+      diag=up;
     }
   }
-  return dp[m][n];
+  return row[n];
 }
 
-std::vector<std::vector<bool>> detectMissingValues(const std::vector<std::vector<std::string>>& data){
-  std::vector<std::vector<bool>> missing;
-  for(const auto& row:data){
-    std::vector<bool> rowMissing;
-    for(const auto& cell:row) rowMissing.push_back(cell.empty());
-    missing.push_back(rowMissing);
-  }
-  return missing;
+// Counts edits in code points, so "café" -> "cafe" is one edit; ASCII
+// inputs skip the decode.
+int levenshteinDistance(const std::string& s1, const std::string& s2){
+  if(isAscii(s1.data(),s1.size())&&isAscii(s2.data(),s2.size()))
+    return editDistance(s1.data(),s1.size(),s2.data(),s2.size());
+  std::vector<char32_t> a,b;
+  decodeUtf8(s1,a);
+  decodeUtf8(s2,b);
+  return editDistance(a.data(),a.size(),b.data(),b.size());
 }
 
-std::vector<bool> detectDuplicates(const std::vector<std::vector<std::string>>& data){
-  std::vector<bool> isDuplicate(data.size(),false);
-  std::set<std::vector<std::string>> seen;
-  for(size_t i=0;i<data.size();++i){
-    if(seen.count(data[i])) isDuplicate[i]=true;
-    else seen.insert(data[i]);
+// Rows are hashed in parallel, scattered by the top bits of their hash into
+// one partition per worker, and each partition is resolved independently on a
+// flat index table. Equal rows always share a partition, and each partition
+// lists its rows in ascending order, so "seen before" means the same as a
+// single serial pass. Only hashes and indices are stored, never row copies.
+std::vector<bool> detectDuplicates(const std::vector<std::vector<std::string>>& data, unsigned int threadCount){
+  const size_t MIN_ROWS_PER_THREAD=4096;
+  size_t n=data.size();
+  std::vector<uint64_t> hashes(n);
+  unsigned int threads=workerCount(n,MIN_ROWS_PER_THREAD,threadCount);
+  parallelChunks(n,threads,[&](unsigned int,size_t b,size_t e){
+    for(size_t i=b;i<e;i++) hashes[i]=hashRow(data[i]);
+  });
+
+  unsigned int bits=0;
+  while((1u<<bits)<threads) bits++;
+  size_t partitions=size_t(1)<<bits;
+  auto partitionOf=[&](size_t i)->size_t{ return bits?static_cast<size_t>(hashes[i]>>(64-bits)):0; };
+
+  // scatter: per-chunk counts, prefix sums, then a stable fill so every
+  // partition keeps its rows in ascending index order
+  std::vector<std::vector<size_t>> counts(threads,std::vector<size_t>(partitions,0));
+  parallelChunks(n,threads,[&](unsigned int t,size_t b,size_t e){
+    for(size_t i=b;i<e;i++) counts[t][partitionOf(i)]++;
+  });
+  std::vector<size_t> partStart(partitions+1,0);
+  std::vector<std::vector<size_t>> cursor(threads,std::vector<size_t>(partitions,0));
+  size_t offset=0;
+  for(size_t p=0;p<partitions;p++){
+    partStart[p]=offset;
+    for(unsigned int t=0;t<threads;t++){ cursor[t][p]=offset; offset+=counts[t][p]; }
   }
-  return isDuplicate;
+  partStart[partitions]=offset;
+  std::vector<uint32_t> order(n);
+  parallelChunks(n,threads,[&](unsigned int t,size_t b,size_t e){
+    for(size_t i=b;i<e;i++) order[cursor[t][partitionOf(i)]++]=static_cast<uint32_t>(i);
+  });
+
+  // flags are bytes while threads write them; vector<bool> packs bits
+  std::vector<uint8_t> flags(n,0);
+  auto sameRow=[&](size_t a,size_t b){ return data[a]==data[b]; };
+  parallelChunks(partitions,threads,[&](unsigned int,size_t pb,size_t pe){
+    for(size_t p=pb;p<pe;p++){
+      RowIndexTable seen(hashes,partStart[p+1]-partStart[p]);
+      for(size_t k=partStart[p];k<partStart[p+1];k++){
+        size_t i=order[k];
+        if(seen.findOrInsert(i,sameRow)!=i) flags[i]=1;
+      }
+    }
+  });
+  return std::vector<bool>(flags.begin(),flags.end());
 }
 
 std::string normalizeForComparison(const std::string& s){
   std::string result;
+  result.reserve(s.size());
+  if(!isAscii(s.data(),s.size())){
+    for(size_t i=0;i<s.size();){
+      char32_t cp=nextCodePoint(s,i);
+      if(cp!=' ') appendUtf8(foldCodePoint(cp),result);
+    }
+    return result;
+  }
   for(char c:s){
-    if(c>='A'&&c<='Z') result+=(char)(c+32);
-    else if(c!=' ') result+=c;
+    if(c!=' ') result+=lowerChar(c);
   }
   return result;
 }
@@ -51,7 +107,7 @@ double calculateSimilarity(const std::string& s1, const std::string& s2){
   std::string norm2=normalizeForComparison(s2);
   if(norm1==norm2) return 1.0;
   int distance=levenshteinDistance(norm1,norm2);
-  int maxLen=static_cast<int>(std::max(norm1.length(),norm2.length()));
+  int maxLen=static_cast<int>(std::max(codePointCount(norm1),codePointCount(norm2)));
   if(maxLen==0) return 1.0;
   return 1.0-(double)distance/maxLen;
 }
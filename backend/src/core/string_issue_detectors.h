@@ -3,14 +3,38 @@
 #include <vector>
 #include <string>
 #include <map>
+#include "bitmap.h"
 
+// Edit distance in code points (UTF-8; invalid bytes count one each).
 int levenshteinDistance(const std::string& s1, const std::string& s2);
+// Case-folded with spaces removed: the form calculateSimilarity compares.
+std::string normalizeForComparison(const std::string& s);
 double calculateSimilarity(const std::string& s1, const std::string& s2);
 double calculateRowSimilarity(const std::vector<std::string>& r1,
   const std::vector<std::string>& r2);
-std::vector<std::vector<bool>> detectMissingValues(const std::vector<std::vector<std::string>>& data);
-std::vector<bool> detectDuplicates(const std::vector<std::vector<std::string>>& data);
-std::vector<int> detectOutliers(const std::vector<std::vector<std::string>>& data);
+// isDuplicate[i] is true when an identical row appears earlier (the header
+// row takes part). threadCount 0 = one worker per hardware thread.
+std::vector<bool> detectDuplicates(const std::vector<std::vector<std::string>>& data,
+  unsigned int threadCount=0);
+// Parses a plain decimal cell ("-12.5", "+3", ".5"); false for anything else.
+bool parseNumericCell(const std::string& str, double& value);
+// IQR: outside [Q1-t*IQR, Q3+t*IQR] (t=1.5); ZSCORE: |x-mean| > t sample
+// standard deviations (t=3); MODIFIED_ZSCORE: 0.6745*|x-median|/MAD > t
+// (t=3.5); PERCENTILE: below the t or above the 1-t quantile (t=0.01).
+enum class OutlierMethod { IQR, ZSCORE, MODIFIED_ZSCORE, PERCENTILE };
+struct OutlierOptions {
+  OutlierMethod method=OutlierMethod::IQR;
+  double threshold=0.0;  // <= 0 takes the method's default t
+};
+// "iqr", "zscore", "modified-zscore", "percentile"; false for anything else.
+bool parseOutlierMethod(const std::string& name, OutlierMethod& method);
+// Bit per row (header included, never set): an outlier by `options` in at
+// least one numeric column (columns with fewer than four numbers are skipped).
+RowBitmap detectOutlierRows(const std::vector<std::vector<std::string>>& data,
+  const OutlierOptions& options=OutlierOptions());
+// detectOutlierRows as ascending row indices.
+std::vector<int> detectOutliers(const std::vector<std::vector<std::string>>& data,
+  const OutlierOptions& options=OutlierOptions());
 
 #endif
 
@@ -1,107 +1,78 @@
 #include "structural_cleaners.h"
 #include "text_normalisation.h"
 #include "string_issue_detectors.h"
+#include "row_hash.h"
 #include <algorithm>
 #include <unordered_map>
 #include <cstdint>
 
-uint64_t fnv1a(const std::vector<std::string>& row){
-  uint64_t hash=14695981039346656037ULL;
-  const uint64_t FNV_PRIME=1099511628211ULL;
-  for(const auto& cell:row){
-    for(char c:cell)
-      hash=(hash^(uint8_t)c)*FNV_PRIME;
-    // Cell boundary marker: separator byte plus cell length, so rows like
-    // ["ab","c"] and ["a","bc"] cannot produce the same byte stream.
-    hash=(hash^(uint8_t)0x1F)*FNV_PRIME;
-    uint64_t len=cell.size();
-    for(int i=0;i<8;i++)
-      hash=(hash^(uint8_t)(len>>(i*8)))*FNV_PRIME;
+std::vector<size_t> findUniqueRows(const std::vector<std::vector<std::string>>& data){
+  std::vector<size_t> kept;
+  if(data.empty()) return kept;
+  kept.push_back(0); // preserve header row
+  std::vector<uint64_t> hashes(data.size());
+  for(size_t i=1;i<data.size();i++) hashes[i]=hashRow(data[i]);
+  RowIndexTable seen(hashes,data.size()-1);
+  auto sameRow=[&](size_t a,size_t b){ return data[a]==data[b]; };
+  for(size_t i=1;i<data.size();i++){
+    if(seen.findOrInsert(i,sameRow)==i) kept.push_back(i);
   }
-  return hash;
+  return kept;
 }
 
 std::vector<std::vector<std::string>> removeDuplicates(const std::vector<std::vector<std::string>>& data){
-  if(data.empty()) return {};
+  std::vector<size_t> kept=findUniqueRows(data);
   std::vector<std::vector<std::string>> result;
-  result.push_back(data[0]); // preserve header row
-  std::unordered_map<uint64_t, std::vector<size_t>> seen;
-  for(size_t i=1;i<data.size();i++){
-    const auto& row=data[i];
-    uint64_t h=fnv1a(row);
-    auto& indices=seen[h];
-    bool duplicate=false;
-    for(size_t idx:indices){
-      if(result[idx]==row){duplicate=true;break;}
-    }
-    if(!duplicate){
-      indices.push_back(result.size());
-      result.push_back(row);
-    }
-  }
+  result.reserve(kept.size());
+  for(size_t i:kept) result.push_back(data[i]);
   return result;
 }
 
-static std::string collapseWhitespace(const std::string& s){
-  std::string out;
-  bool inSpace=false;
-  for(char c : s){
-    if(c==' ' || c=='\t' || c=='\r' || c=='\n'){
-      if(!inSpace){ out+=' '; inSpace=true; }
-    }else{
-      out+=c;
-      inSpace=false;
-    }
+std::vector<std::vector<std::string>> removeDuplicates(std::vector<std::vector<std::string>>&& data){
+  std::vector<size_t> kept=findUniqueRows(data);
+  // kept is ascending, so compacting in place never overwrites a row still to be read
+  for(size_t k=0;k<kept.size();k++){
+    if(kept[k]!=k) data[k]=std::move(data[kept[k]]);
   }
-  // trim trailing space from collapse
-  while(!out.empty() && out.back()==' ') out.pop_back();
-  // trim leading space from collapse
-  size_t lead=0;
-  while(lead<out.size() && out[lead]==' ') lead++;
-  return out.substr(lead);
+  data.resize(kept.size());
+  return std::move(data);
+}
+
+// Trims each cell of space/tab/CR/LF and collapses interior runs to one
+// space, rewriting the cells where they are.
+std::vector<std::vector<std::string>> trimWhitespace(std::vector<std::vector<std::string>>&& data){
+  for(auto& row:data)
+    for(auto& cell:row) normaliseWhitespaceInPlace(cell);
+  return std::move(data);
 }
 
 std::vector<std::vector<std::string>> trimWhitespace(const std::vector<std::vector<std::string>>& data){
-  std::vector<std::vector<std::string>> result;
-  for(const auto& row:data){
-    std::vector<std::string> newRow;
-    for(const auto& cell:row){
-      // trim edges of \r, \n, \t, space
-      size_t start=cell.find_first_not_of(" \t\r\n");
-      size_t end=cell.find_last_not_of(" \t\r\n");
-      std::string trimmed;
-      if(start!=std::string::npos) trimmed=cell.substr(start,end-start+1);
-      else trimmed="";
-      // collapse internal whitespace runs
-      newRow.push_back(collapseWhitespace(trimmed));
-    }
-    result.push_back(newRow);
-  }
-  return result;
+  return trimWhitespace(std::vector<std::vector<std::string>>(data));
 }
 
 std::vector<std::vector<std::string>> standardiseCase(
   const std::vector<std::vector<std::string>>& data, const std::string& caseType){
-  std::vector<std::vector<std::string>> result;
-  for(const auto& row:data){
-    std::vector<std::string> newRow;
-    for(const auto& cell:row){
-      if(caseType=="upper") newRow.push_back(toUpperCase(cell));
-      else if(caseType=="lower") newRow.push_back(toLowerCase(cell));
-      else newRow.push_back(cell);
+  std::vector<std::vector<std::string>> result=data;
+  if(caseType!="upper"&&caseType!="lower") return result;
+  for(auto& row:result)
+    for(auto& cell:row){
+      if(caseType=="upper") toUpperCaseInPlace(cell);
+      else toLowerCaseInPlace(cell);
     }
-    result.push_back(newRow);
-  }
   return result;
 }
 
 std::vector<std::vector<std::string>> standardiseNullValuesInData(
-  const std::vector<std::vector<std::string>>& data){
+  const std::vector<std::vector<std::string>>& data, MissingValueMap* missing){
   std::vector<std::vector<std::string>> result;
+  result.reserve(data.size());
+  if(missing) *missing=MissingValueMap(data.empty()?0:data[0].size());
   for(const auto& row:data){
     std::vector<std::string> newRow;
+    newRow.reserve(row.size());
     for(const auto& cell:row) newRow.push_back(standardiseNullValues(cell));
-    result.push_back(newRow);
+    if(missing) missing->addRow(newRow);
+    result.push_back(std::move(newRow));
   }
   return result;
 }
@@ -3,18 +3,49 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <cstdint>
+#include <string_view>
+#include "string_issue_detectors.h"
+#include "missing_values.h"
 
+// Indices of the header row and the first occurrence of every distinct data
+// row, in ascending order.
+std::vector<size_t> findUniqueRows(const std::vector<std::vector<std::string>>& data);
 std::vector<std::vector<std::string>> removeDuplicates(const std::vector<std::vector<std::string>>& data);
+std::vector<std::vector<std::string>> removeDuplicates(std::vector<std::vector<std::string>>&& data);
 std::vector<std::vector<std::string>> trimWhitespace(const std::vector<std::vector<std::string>>& data);
+std::vector<std::vector<std::string>> trimWhitespace(std::vector<std::vector<std::string>>&& data);
 std::vector<std::vector<std::string>> standardiseCase(
   const std::vector<std::vector<std::string>>& data, const std::string& caseType);
+// Null tokens ("N/A", "null", "-", ...) become empty cells; `missing`, when
+// given, receives the resulting missing-value map from the same pass.
 std::vector<std::vector<std::string>> standardiseNullValuesInData(
-  const std::vector<std::vector<std::string>>& data);
+  const std::vector<std::vector<std::string>>& data, MissingValueMap* missing=nullptr);
+// BLOCKED compares only sorted-neighbourhood candidates (scored in parallel);
+// EXHAUSTIVE compares all pairs and is meant for small inputs.
+enum class FuzzyDedupMode { BLOCKED, EXHAUSTIVE };
 std::vector<std::vector<std::string>> fuzzyDeduplicateRows(
-  const std::vector<std::vector<std::string>>& data, double threshold);
+  const std::vector<std::vector<std::string>>& data, double threshold,
+  FuzzyDedupMode mode=FuzzyDedupMode::BLOCKED, unsigned int threadCount=0);
+// Appends the natural sort key of `cell`: keys compare bytewise (then by
+// length) in natural order, with digit runs of any length ordered by value
+// ("file2" < "file10"). Built once per cell instead of re-parsing digit runs
+// in every comparison.
+void appendNaturalSortKey(std::string_view cell, std::string& out);
+std::string naturalSortKey(std::string_view cell);
+// Data rows (indices from 1) in natural order of column `colIndex`; a stable
+// sort of a uint32 permutation over precomputed keys, parallel for large
+// inputs (threadCount 0 = hardware concurrency).
+std::vector<uint32_t> naturalSortOrder(const std::vector<std::vector<std::string>>& data, int colIndex,
+  unsigned int threadCount=0);
+// The header stays first; rows are copied (or moved) once, in sorted order.
+// An out-of-range column returns the data unchanged.
 std::vector<std::vector<std::string>> naturalSort(
-  const std::vector<std::vector<std::string>>& data, int colIndex);
-std::vector<std::vector<std::string>> removeOutliers(const std::vector<std::vector<std::string>>& data);
+  const std::vector<std::vector<std::string>>& data, int colIndex, unsigned int threadCount=0);
+std::vector<std::vector<std::string>> naturalSort(
+  std::vector<std::vector<std::string>>&& data, int colIndex, unsigned int threadCount=0);
+std::vector<std::vector<std::string>> removeOutliers(const std::vector<std::vector<std::string>>& data,
+  const OutlierOptions& options=OutlierOptions());
 
 #endif
 
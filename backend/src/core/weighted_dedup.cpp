@@ -1,8 +1,12 @@
 #include "weighted_dedup.h"
 #include "string_issue_detectors.h"
 #include "text_normalisation.h"
+#include "char_class.h"
+#include "similarity_kernels.h"
+#include "blocking_keys.h"
 #include <algorithm>
 #include <cmath>
+#include <memory>
 #include <numeric>
 #include <unordered_set>
 
@@ -10,7 +14,7 @@ static const int BLOCKING_WINDOW = 20;
 
 // --- cell normalisation per type ----------------------------------------
 
-static std::string normaliseForType(const std::string& cell, ColumnType type) {
+std::string normaliseForType(const std::string& cell, ColumnType type) {
   switch (type) {
     case ColumnType::EMAIL:
     case ColumnType::URL:
@@ -20,9 +24,10 @@ static std::string normaliseForType(const std::string& cell, ColumnType type) {
       {
         // strip everything except digits and leading +
         std::string out;
+        out.reserve(cell.size());
         for (char c : cell) {
           if (c == '+' && out.empty()) out += c;
-          else if (c >= '0' && c <= '9') out += c;
+          else if (charClass(c) & CC_DIGIT) out += c;
         }
         return out;
       }
@@ -84,10 +89,10 @@ static std::string normaliseForType(const std::string& cell, ColumnType type) {
     case ColumnType::ID:
       // trim and preserve exact value
       {
-        size_t s = cell.find_first_not_of(" \t\r\n");
-        size_t e = cell.find_last_not_of(" \t\r\n");
-        if (s == std::string::npos) return "";
-        return cell.substr(s, e - s + 1);
+        size_t s = 0, e = cell.size();
+        while (s < e && (charClass(cell[s]) & CC_BLANK)) s++;
+        while (e > s && (charClass(cell[e - 1]) & CC_BLANK)) e--;
+        return cell.substr(s, e - s);
       }
 
     case ColumnType::NAME:
@@ -98,104 +103,85 @@ static std::string normaliseForType(const std::string& cell, ColumnType type) {
   }
 }
 
+// --- prepared cells -------------------------------------------------------
+
+PreparedRow prepareRow(const std::vector<std::string>& row,
+                       const std::vector<ColumnType>& columnTypes) {
+  size_t n = std::min(row.size(), columnTypes.size());
+  PreparedRow out(n);
+  for (size_t i = 0; i < n; i++) {
+    PreparedCell& cell = out[i];
+    cell.empty = row[i].empty();
+    if (cell.empty) continue;
+    switch (columnTypes[i]) {
+      case ColumnType::NAME:
+        cell.norm = normalizeForComparison(row[i]);
+        cell.tokens = sortedTokens(row[i]);
+        break;
+      case ColumnType::GENERIC_TEXT:
+        cell.norm = normalizeForComparison(row[i]);
+        break;
+      case ColumnType::FREE_TEXT:
+        cell.grams = std::make_unique<QGramSignature>(qgramSignature(row[i]));
+        break;
+      default:
+        cell.norm = normaliseForType(row[i], columnTypes[i]);
+        break;
+    }
+  }
+  return out;
+}
+
 // --- cell similarity by type --------------------------------------------
 
-static double cellSimilarity(const std::string& a, const std::string& b, ColumnType type) {
+static double cellSimilarity(const PreparedCell& a, const PreparedCell& b, ColumnType type) {
   // missing-value half-credit
-  if (a.empty() || b.empty()) return 0.5;
+  if (a.empty || b.empty) return 0.5;
 
   switch (type) {
-    case ColumnType::EMAIL:
-    case ColumnType::PHONE:
-    case ColumnType::ID:
-      {
-        std::string na = normaliseForType(a, type);
-        std::string nb = normaliseForType(b, type);
-        return na == nb ? 1.0 : 0.0;
-      }
-
-    case ColumnType::URL:
-    case ColumnType::DATE:
-    case ColumnType::NUMERIC:
-    case ColumnType::BOOLEAN:
-      {
-        std::string na = normaliseForType(a, type);
-        std::string nb = normaliseForType(b, type);
-        return na == nb ? 1.0 : 0.0;
-      }
-
     case ColumnType::NAME:
+      // typos score through Jaro-Winkler, swapped tokens ("Smith John")
+      // through the token-sort ratio
+      return std::max(jaroWinkler(a.norm, b.norm), tokenSortRatio(a.tokens, b.tokens));
+
     case ColumnType::GENERIC_TEXT:
+      return levenshteinRatio(a.norm, b.norm);
+
     case ColumnType::FREE_TEXT:
-      return calculateSimilarity(a, b);  // Levenshtein-based
+      // long prose: trigram overlap instead of quadratic edit distance
+      return qgramJaccard(*a.grams, *b.grams);
 
     default:
-      return a == b ? 1.0 : 0.0;
+      // EMAIL, PHONE, ID, URL, DATE, NUMERIC, BOOLEAN: exact after normalising
+      return a.norm == b.norm ? 1.0 : 0.0;
   }
 }
 
 // --- row similarity (weighted) ------------------------------------------
 
-static double rowSimilarity(const std::vector<std::string>& r1,
-                            const std::vector<std::string>& r2,
-                            const std::vector<ColumnType>& columnTypes) {
+double rowSimilarity(const PreparedRow& r1, const PreparedRow& r2,
+                     const std::vector<ColumnType>& columnTypes) {
   size_t minCols = std::min({r1.size(), r2.size(), columnTypes.size()});
   if (minCols == 0) return 0.0;
 
   double weightedSum = 0.0;
   double totalWeight = 0.0;
-  bool idVeto = false;
 
   for (size_t i = 0; i < minCols; i++) {
-    double w = typeWeight(columnTypes[i]);
-    double sim = cellSimilarity(r1[i], r2[i], columnTypes[i]);
-
     // hard veto: identifier disagreement kills the row
-    if (columnTypes[i] == ColumnType::ID && !r1[i].empty() && !r2[i].empty()) {
-      std::string n1 = normaliseForType(r1[i], ColumnType::ID);
-      std::string n2 = normaliseForType(r2[i], ColumnType::ID);
-      if (n1 != n2) {
-        idVeto = true;
-      }
+    if (columnTypes[i] == ColumnType::ID && !r1[i].empty && !r2[i].empty &&
+        r1[i].norm != r2[i].norm) {
+      return 0.0;
     }
-
-    weightedSum += w * sim;
+    double w = typeWeight(columnTypes[i]);
+    weightedSum += w * cellSimilarity(r1[i], r2[i], columnTypes[i]);
     totalWeight += w;
   }
 
-  if (idVeto) return 0.0;
   if (totalWeight == 0.0) return 0.0;
   return weightedSum / totalWeight;
 }
 
-// --- blocking key -------------------------------------------------------
-
-static std::string blockingKey(const std::vector<std::string>& row,
-                               const std::vector<ColumnType>& columnTypes) {
-  std::string key;
-  size_t n = std::min(row.size(), columnTypes.size());
-  for (size_t i = 0; i < n; i++) {
-    // use non-ID text columns for the blocking key
-    if (columnTypes[i] == ColumnType::ID ||
-        columnTypes[i] == ColumnType::NUMERIC ||
-        columnTypes[i] == ColumnType::BOOLEAN ||
-        columnTypes[i] == ColumnType::DATE) continue;
-
-    std::string norm = normaliseForType(row[i], columnTypes[i]);
-    // lower-case and strip spaces for a fuzzy sort key
-    std::string flat;
-    for (char c : norm) {
-      if (c >= 'A' && c <= 'Z') flat += (char)(c + 32);
-      else if (c != ' ' && c != '\t' && c != '\r' && c != '\n') flat += c;
-    }
-    if (!flat.empty()) {
-      if (!key.empty()) key += '|';
-      key += flat;
-    }
-  }
-  return key;
-}
-
 // --- main dedup function ------------------------------------------------
 
 WeightedDedupResult weightedDeduplicate(
@@ -210,37 +196,32 @@ WeightedDedupResult weightedDeduplicate(
     return result;
   }
 
-  // build (blockingKey, originalIndex) pairs for data rows only (skip header)
-  struct IndexedKey {
-    std::string key;
-    size_t originalIdx;
-  };
-  std::vector<IndexedKey> indexed;
+  // (blocking key, original index) for data rows only (skip header); the
+  // index tie-break keeps the sort stable
+  std::vector<std::pair<uint64_t, size_t>> indexed;
   indexed.reserve(data.size() - 1);
   for (size_t i = 1; i < data.size(); i++) {
-    indexed.push_back({blockingKey(data[i], columnTypes), i});
+    indexed.push_back({rowBlockingKey(data[i], columnTypes), i});
   }
+  std::sort(indexed.begin(), indexed.end());
 
-  // stable sort by blocking key
-  std::stable_sort(indexed.begin(), indexed.end(),
-                   [](const IndexedKey& a, const IndexedKey& b) {
-                     return a.key < b.key;
-                   });
+  std::vector<PreparedRow> prepared(data.size());
+  for (size_t i = 1; i < data.size(); i++) prepared[i] = prepareRow(data[i], columnTypes);
 
   // sliding-window dedup
   std::vector<bool> isDuplicate(data.size(), false);
   isDuplicate[0] = false; // header is never a duplicate
 
   for (size_t i = 0; i < indexed.size(); i++) {
-    size_t origI = indexed[i].originalIdx;
+    size_t origI = indexed[i].second;
     if (isDuplicate[origI]) continue;
 
     size_t windowEnd = std::min(indexed.size(), i + BLOCKING_WINDOW);
     for (size_t j = i + 1; j < windowEnd; j++) {
-      size_t origJ = indexed[j].originalIdx;
+      size_t origJ = indexed[j].second;
       if (isDuplicate[origJ]) continue;
 
-      double sim = rowSimilarity(data[origI], data[origJ], columnTypes);
+      double sim = rowSimilarity(prepared[origI], prepared[origJ], columnTypes);
       if (sim >= threshold) {
         isDuplicate[origJ] = true;
       }
@@ -1,15 +1,43 @@
 #ifndef WEIGHTED_DEDUP_H
 #define WEIGHTED_DEDUP_H
 
+#include <memory>
 #include <vector>
 #include <string>
 #include "column_type_detection.h"
+#include "similarity_kernels.h"
 
 struct WeightedDedupResult {
   std::vector<std::vector<std::string>> data;
   int rowsRemoved;
 };
 
+// Exact-match form of a cell for the strict types: lower-cased email/URL,
+// digits-only phone, ISO date, canonical boolean and number, trimmed ID.
+// Text types are returned unchanged.
+std::string normaliseForType(const std::string& cell, ColumnType type);
+
+// Everything a comparison needs from a cell, computed once per row instead
+// of once per pair: the exact-match form for strict types, the comparison
+// form and sorted tokens for NAME/GENERIC_TEXT, a trigram signature for
+// FREE_TEXT (held by pointer: only FREE_TEXT cells pay for the 256 bytes).
+struct PreparedCell {
+  bool empty = true;
+  std::string norm;
+  std::string tokens;
+  std::unique_ptr<QGramSignature> grams;
+};
+
+using PreparedRow = std::vector<PreparedCell>;
+
+PreparedRow prepareRow(const std::vector<std::string>& row,
+                       const std::vector<ColumnType>& columnTypes);
+
+// Weighted mean of per-type cell similarities (typeWeight), 0 when two
+// non-empty ID cells differ.
+double rowSimilarity(const PreparedRow& r1, const PreparedRow& r2,
+                     const std::vector<ColumnType>& columnTypes);
+
 WeightedDedupResult weightedDeduplicate(
     const std::vector<std::vector<std::string>>& data,
     const std::vector<ColumnType>& columnTypes,
@@ -2,11 +2,17 @@
 #include "csv_parser.h"
 #include "csv_serializer.h"
 #include "text_normalisation.h"
+#include "null_tokens.h"
 #include "string_issue_detectors.h"
 #include "structural_cleaners.h"
 #include "column_type_detection.h"
 #include "weighted_dedup.h"
 #include "deep_clean.h"
+#include "external_dedup.h"
+#include "external_sort.h"
+#include "cardinality_sketch.h"
+#include "dedup_index.h"
+#include "record_linkage.h"
 #include "cluster_detection.h"
 #include "audit.h"
 #include "logger.h"
@@ -25,8 +31,12 @@
 #include <cerrno>
 #include <cstring>
 #include <unistd.h>
+#include <cstdint>
 #include <cstdlib>
 #include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <memory>
 
 void registerAdditionalRoutes(crow::SimpleApp& app);
 void registerTextRoutes(crow::SimpleApp& app);
@@ -53,14 +63,147 @@ static bool checkAdminAuth(const crow::request& req) {
   return sameLength && acc == 0;
 }
 
+// Opens the persistent dedup index for a request's "dedupIndex" token; the
+// token is a client-held secret, so other callers cannot read or add to the
+// index.  Returns null with `error` set for a malformed token (400), an
+// upload whose header differs from the indexed one (409) or an unreadable
+// index (500).
+static std::unique_ptr<DedupIndex> openDedupIndex(const std::string& token,
+    const std::vector<std::string>& header, const std::vector<ColumnType>& columnTypes,
+    crow::response& error) {
+  if (!isValidIndexToken(token)) {
+    error = crow::response(400, "dedupIndex must be a secret token of 32-128 characters of A-Z, a-z, 0-9, _ or -");
+    return nullptr;
+  }
+  try {
+    return std::make_unique<DedupIndex>(indexNameForToken(token), header, columnTypes);
+  } catch (const std::invalid_argument& e) {
+    error = crow::response(409, e.what());
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    error = crow::response(500, "Dedup index unavailable");
+  }
+  return nullptr;
+}
+
+// Parses the --memory-mb N and --temp-dir DIR flags of the batch modes from
+// argv[first..].  Reports the problem and returns false for an unknown flag,
+// a flag without a value, or a memory size that is not a positive integer.
+static bool parseSpillFlags(int argc, char** argv, int first, size_t& memoryBudgetBytes,
+                            std::string& tempDir) {
+  for (int i = first; i < argc; i += 2) {
+    std::string flag = argv[i];
+    if (flag != "--memory-mb" && flag != "--temp-dir") {
+      std::cerr << "unknown option " << flag << std::endl;
+      return false;
+    }
+    if (i + 1 >= argc) {
+      std::cerr << flag << " needs a value" << std::endl;
+      return false;
+    }
+    if (flag == "--memory-mb") {
+      char* end = nullptr;
+      errno = 0;
+      long mb = std::strtol(argv[i + 1], &end, 10);
+      if (end == argv[i + 1] || *end != '\0' || errno == ERANGE || mb <= 0 ||
+          static_cast<unsigned long>(mb) > (SIZE_MAX >> 20)) {
+        std::cerr << "--memory-mb must be a positive number" << std::endl;
+        return false;
+      }
+      memoryBudgetBytes = static_cast<size_t>(mb) << 20;
+    } else {
+      tempDir = argv[i + 1];
+    }
+  }
+  return true;
+}
+
+// Offline mode for exports too large for the 50MB route cap:
+//   Toolkit --batch-dedup <input.csv> <output.csv> [--memory-mb N] [--temp-dir DIR]
+static int runBatchDedup(int argc, char** argv) {
+  const std::string usage = std::string("usage: ") + argv[0] +
+      " --batch-dedup <input.csv> <output.csv> [--memory-mb N] [--temp-dir DIR]";
+  ExternalDedupOptions options;
+  if (argc < 4 || !parseSpillFlags(argc, argv, 4, options.memoryBudgetBytes, options.tempDir)) {
+    std::cerr << usage << std::endl;
+    return 2;
+  }
+  std::ifstream in(argv[2], std::ios::binary);
+  if (!in) { std::cerr << "cannot open " << argv[2] << std::endl; return 1; }
+  std::ofstream out(argv[3], std::ios::binary | std::ios::trunc);
+  if (!out) { std::cerr << "cannot create " << argv[3] << std::endl; return 1; }
+  std::error_code ec;
+  auto size = std::filesystem::file_size(argv[2], ec);
+  if (!ec) options.inputSizeHint = static_cast<size_t>(size);
+  try {
+    auto stats = externalDeduplicate(in, out, options);
+    out.close();
+    if (!out) { std::cerr << "cannot write " << argv[3] << std::endl; return 1; }
+    std::cerr << "batch dedup: " << stats.rowsRead << " rows read, " << stats.rowsKept << " kept, "
+              << stats.partitions << " partitions, " << stats.repartitions << " re-split" << std::endl;
+  } catch (const std::exception& e) {
+    std::cerr << "batch dedup failed: " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+static int runBatchSort(int argc, char** argv) {
+  const std::string usage = std::string("usage: ") + argv[0] +
+      " --batch-sort <input.csv> <output.csv> <column> [--memory-mb N] [--temp-dir DIR]";
+  if (argc < 5) {
+    std::cerr << usage << std::endl;
+    return 2;
+  }
+  char* end = nullptr;
+  long column = std::strtol(argv[4], &end, 10);
+  if (end == argv[4] || *end != '\0' || column < 0 || column > INT32_MAX) {
+    std::cerr << "column must be a non-negative index" << std::endl;
+    return 2;
+  }
+  ExternalSortOptions options;
+  if (!parseSpillFlags(argc, argv, 5, options.memoryBudgetBytes, options.tempDir)) {
+    std::cerr << usage << std::endl;
+    return 2;
+  }
+  std::ifstream in(argv[2], std::ios::binary);
+  if (!in) { std::cerr << "cannot open " << argv[2] << std::endl; return 1; }
+  std::ofstream out(argv[3], std::ios::binary | std::ios::trunc);
+  if (!out) { std::cerr << "cannot create " << argv[3] << std::endl; return 1; }
+  try {
+    auto stats = externalNaturalSort(in, out, static_cast<int>(column), options);
+    out.close();
+    if (!out) { std::cerr << "cannot write " << argv[3] << std::endl; return 1; }
+    std::cerr << "batch sort: " << stats.rowsRead << " rows, " << stats.runs << " runs, "
+              << stats.mergePasses << " merge passes" << std::endl;
+  } catch (const std::exception& e) {
+    std::cerr << "batch sort failed: " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
 
+// Extra null tokens for this deployment (TOOLKIT_NULL_TOKENS, comma-separated).
+// A bad list is reported and ignored rather than stopping the server.
+static void configureNullTokens() {
+  auto tokens = nullTokensFromEnvironment();
+  if (tokens.empty()) return;
+  std::string error;
+  if (setCustomNullTokens(tokens, &error))
+    std::cerr << "Null tokens: " << tokens.size() << " custom token(s) from TOOLKIT_NULL_TOKENS" << std::endl;
+  else
+    std::cerr << "Warning: TOOLKIT_NULL_TOKENS ignored: " << error << std::endl;
+}
 
-int main(){
+int main(int argc, char** argv){
   // Privacy hardening: disable core dumps to prevent heap memory (which may
   // contain user-uploaded CSV data) from being written to disk on crash.
   if (prctl(PR_SET_DUMPABLE, 0) == -1) {
     std::cerr << "Warning: prctl(PR_SET_DUMPABLE,0) failed: " << std::strerror(errno) << std::endl;
   }
+  configureNullTokens();
+  if (argc > 1 && std::string(argv[1]) == "--batch-dedup") return runBatchDedup(argc, argv);
+  if (argc > 1 && std::string(argv[1]) == "--batch-sort") return runBatchSort(argc, argv);
   crow::SimpleApp app;
   // Privacy hardening: lock existing memory mappings to reduce the likelihood
   // of the kernel swapping heap pages (which may contain user-uploaded CSV
@@ -171,7 +314,39 @@ int main(){
     auto parsed=parseCSV(csvData);
     int originalRows=static_cast<int>(parsed.size());
 
-    DeepCleanResult cleaned=deepClean(parsed);
+    DeepCleanResult cleaned=deepCleanExact(parsed);
+
+    // optional persistent index: rows an earlier upload already kept are
+    // dropped before the fuzzy pass, so it only compares the new ones; this
+    // upload's survivors are then added
+    std::unique_ptr<DedupIndex> index;
+    int indexMatches=0;
+    size_t indexRows=0;
+    bool useIndex=json.has("dedupIndex") && !cleaned.cleanedData.empty();
+    if(useIndex){
+      crow::response error;
+      index=openDedupIndex(json["dedupIndex"].s(), cleaned.cleanedData[0], cleaned.columnTypes, error);
+      if(!index){logRequest("POST", "/api/clean", error.code); return error;}
+      int before=(int)cleaned.cleanedData.size();
+      auto filtered=index->filter(cleaned.cleanedData, 0.95);
+      indexMatches=filtered.exactMatches+filtered.fuzzyMatches;
+      cleaned.cleanedData=std::move(filtered.data);
+      cleaned.auditLog.addEntry("Dedup Index Filter", 0, before, (int)cleaned.cleanedData.size(), "dedup-index");
+    }
+
+    deepCleanFuzzy(cleaned);
+
+    if(index){
+      try{
+        index->add(cleaned.cleanedData);
+        index->save();
+      }catch(const std::exception& e){
+        std::cerr << e.what() << std::endl;
+        logRequest("POST", "/api/clean", 500);
+        return crow::response(500, "Dedup index unavailable");
+      }
+      indexRows=index->size();
+    }
 
     std::string outputCsv=serializeToCSV(cleaned.cleanedData);
     int cleanedRows=static_cast<int>(cleaned.cleanedData.size());
@@ -182,6 +357,10 @@ int main(){
     resp["cleanedRows"]=cleanedRows;
     resp["rowsRemoved"]=originalRows-cleanedRows;
     resp["message"]="Data cleaned successfully";
+    if(useIndex){
+      resp["indexMatches"]=indexMatches;
+      resp["indexRows"]=(int)indexRows;
+    }
 
     // columnTypes
     resp["columnTypes"]=crow::json::wvalue::list();
@@ -237,23 +416,55 @@ int main(){
         else columnTypes.push_back(ColumnType::GENERIC_TEXT);
       }
     } else {
-      auto typeResult=detectColumnTypes(parsed);
+      auto typeResult=detectColumnTypesFull(parsed);
       columnTypes=typeResult.types;
     }
 
     // exact dedup first
-    auto exactDeduped=removeDuplicates(parsed);
-    int exactRemoved=(int)parsed.size()-(int)exactDeduped.size();
-    auditLog.addEntry("Exact Deduplication", 0, (int)parsed.size(), (int)exactDeduped.size(), "dedup-pass-2-exact");
+    int parsedRows=(int)parsed.size();
+    auto exactDeduped=removeDuplicates(std::move(parsed));
+    int exactRemoved=parsedRows-(int)exactDeduped.size();
+    auditLog.addEntry("Exact Deduplication", 0, parsedRows, (int)exactDeduped.size(), "dedup-pass-2-exact");
+
+    // optional persistent index: rows an earlier upload already kept are
+    // dropped here, so the fuzzy pass only compares the new ones
+    std::unique_ptr<DedupIndex> index;
+    int indexMatches=0;
+    if(json.has("dedupIndex") && !exactDeduped.empty()){
+      crow::response error;
+      index=openDedupIndex(json["dedupIndex"].s(), exactDeduped[0], columnTypes, error);
+      if(!index){logRequest("POST", "/api/post-merge-dedup", error.code); return error;}
+      int before=(int)exactDeduped.size();
+      auto filtered=index->filter(exactDeduped, 0.92);
+      indexMatches=filtered.exactMatches+filtered.fuzzyMatches;
+      exactDeduped=std::move(filtered.data);
+      auditLog.addEntry("Dedup Index Filter", 0, before, (int)exactDeduped.size(), "dedup-index");
+      columnTypes=index->columnTypes();
+    }
 
     // then weighted fuzzy at slightly looser threshold
     auto fuzzyResult=weightedDeduplicate(exactDeduped, columnTypes, 0.92);
     auditLog.addEntry("Weighted Fuzzy Deduplication", 0, (int)exactDeduped.size(), (int)fuzzyResult.data.size(), "dedup-pass-2-fuzzy");
 
+    if(index){
+      try{
+        index->add(fuzzyResult.data);
+        index->save();
+      }catch(const std::exception& e){
+        std::cerr << e.what() << std::endl;
+        logRequest("POST", "/api/post-merge-dedup", 500);
+        return crow::response(500, "Dedup index unavailable");
+      }
+    }
+
     std::string outputCsv=serializeToCSV(fuzzyResult.data);
     crow::json::wvalue resp;
     resp["csvData"]=outputCsv;
-    resp["rowsRemoved"]=fuzzyResult.rowsRemoved + exactRemoved;
+    resp["rowsRemoved"]=fuzzyResult.rowsRemoved + exactRemoved + indexMatches;
+    if(index){
+      resp["indexMatches"]=indexMatches;
+      resp["indexRows"]=(int)index->size();
+    }
 
     resp["auditLog"]=crow::json::wvalue::list();
     for(size_t i=0;i<auditLog.entries.size();i++){
@@ -271,6 +482,53 @@ int main(){
     cresp.set_header("Content-Type","application/json; charset=utf-8");
     return cresp;
   });
+  CROW_ROUTE(app,"/api/link-records").methods("POST"_method)
+  ([](const crow::request& req){
+    const std::string clientIp = resolveClientIp(req.get_header_value("x-forwarded-for"), req.remote_ip_address);
+    if (!checkRateLimit(clientIp)) {logRequest("POST", "/api/link-records", 429); return crow::response(429);}
+    if (req.body.size() > 50 * 1024 * 1024) return crow::response(413, "Payload too large. Maximum 50MB.");
+    if (!tryAcquireConnection(clientIp)) return crow::response(429, "Too many concurrent requests from your IP");
+    ConnectionGuard connGuard(clientIp);
+    recordEndpointCall("/api/link-records");
+    auto json=crow::json::load(req.body);
+    if(!json || !json.has("tableA") || !json.has("tableB")){
+      logRequest("POST", "/api/link-records", 400);
+      return crow::response(400, "Expected JSON with tableA and tableB CSV strings");
+    }
+    double threshold=json.has("threshold") ? json["threshold"].d() : 0.9;
+    if(!(threshold>0.0 && threshold<=1.0)){
+      logRequest("POST", "/api/link-records", 400);
+      return crow::response(400, "threshold must be in (0, 1]");
+    }
+    auto tableA=parseCSV(json["tableA"].s());
+    auto tableB=parseCSV(json["tableB"].s());
+
+    // the tables are blocked and scored side by side, never concatenated
+    auto columns=linkColumns(tableA, tableB);
+    auto linked=linkRecords(tableA, tableB, columns, threshold);
+
+    crow::json::wvalue resp;
+    resp["columns"]=crow::json::wvalue::list();
+    for(size_t i=0;i<columns.size();i++){
+      resp["columns"][i]["columnA"]=tableA[0][columns[i].columnA];
+      resp["columns"][i]["columnB"]=tableB[0][columns[i].columnB];
+      resp["columns"][i]["type"]=columnTypeToString(columns[i].type);
+    }
+    resp["matches"]=crow::json::wvalue::list();
+    for(size_t i=0;i<linked.matches.size();i++){
+      const auto& m=linked.matches[i];
+      resp["matches"][i]["rowA"]=(int)m.rowA;
+      resp["matches"][i]["rowB"]=(int)m.rowB;
+      resp["matches"][i]["score"]=m.score;
+    }
+    resp["matchCount"]=(int)linked.matches.size();
+    resp["comparisons"]=(int)linked.comparisons;
+
+    logRequest("POST", "/api/link-records", 200);
+    auto cresp=crow::response(resp);
+    cresp.set_header("Content-Type","application/json; charset=utf-8");
+    return cresp;
+  });
   CROW_ROUTE(app,"/api/detect-duplicates").methods("POST"_method)
   ([](const crow::request& req){
     const std::string clientIp = resolveClientIp(req.get_header_value("x-forwarded-for"), req.remote_ip_address);
@@ -279,6 +537,26 @@ int main(){
     if (!tryAcquireConnection(clientIp)) return crow::response(429, "Too many concurrent requests from your IP");
     ConnectionGuard connGuard(clientIp);
     recordEndpointCall("/api/detect-duplicates");
+    // ?estimate=true: one streaming pass over HyperLogLog sketches (a few KB
+    // of state) for the upload preview, instead of exact detection
+    const char* estimate=req.url_params.get("estimate");
+    if(estimate && std::string(estimate)=="true"){
+      CsvRecordReader reader(req.body);
+      auto est=estimateDuplicates(reader);
+      crow::json::wvalue result;
+      result["estimated"]=true;
+      result["rows"]=(int)est.rows;
+      result["duplicateCount"]=(int)std::llround(est.duplicateRows);
+      result["distinctRows"]=(int)std::llround(est.distinctRows);
+      result["columnCardinality"]=crow::json::wvalue::list();
+      for(size_t i=0;i<est.columnNames.size();i++){
+        result["columnCardinality"][i]["columnName"]=est.columnNames[i];
+        result["columnCardinality"][i]["distinct"]=(int)std::llround(est.columnCardinality[i]);
+        result["columnCardinality"][i]["type"]=columnTypeToString(est.columnTypes[i]);
+      }
+      logRequest("POST", "/api/detect-duplicates", 200);
+      return crow::response(result);
+    }
     auto parsed=parseCSV(req.body);
     auto dups=detectDuplicates(parsed);
     int count=0;
@@ -54,3 +54,45 @@ std::vector<std::vector<std::string>> parseCSV(const std::string& data){
   if(rowHasContent){ row.push_back(cell); result.push_back(row); }
   return result;
 }
+
+CsvRecordReader::CsvRecordReader(std::istream& in, size_t bufferSize)
+  :in_(&in),buf_(bufferSize>0?bufferSize:1),data_(buf_.data()){}
+
+CsvRecordReader::CsvRecordReader(std::string_view data)
+  :data_(data.data()),end_(data.size()){}
+
+bool CsvRecordReader::fill(){
+  if(!in_ || !*in_) return false;
+  in_->read(buf_.data(),static_cast<std::streamsize>(buf_.size()));
+  pos_=0;
+  end_=static_cast<size_t>(in_->gcount());
+  return end_>0;
+}
+
+// Same state machine as parseCSV, pulling bytes from the buffer instead of
+// indexing into a string.
+bool CsvRecordReader::next(std::vector<std::string>& row){
+  row.clear();
+  std::string cell;
+  bool inQuotes=false;
+  bool rowHasContent=false;
+  for(int c=get();c!=-1;c=get()){
+    if(inQuotes){
+      if(c=='"'){
+        if(peek()=='"'){ cell+='"'; ++pos_; }
+        else inQuotes=false;
+      }else cell+=static_cast<char>(c);
+    }else{
+      if(c=='"' && cell.empty()){ inQuotes=true; rowHasContent=true; }
+      else if(c==','){ row.push_back(std::move(cell)); cell.clear(); rowHasContent=true; }
+      else if(c=='\n' || (c=='\r' && peek()=='\n')){
+        if(c=='\r') ++pos_;
+        if(rowHasContent){ row.push_back(std::move(cell)); return true; }
+        row.clear(); cell.clear();
+      }
+      else{ cell+=static_cast<char>(c); rowHasContent=true; }
+    }
+  }
+  if(rowHasContent){ row.push_back(std::move(cell)); return true; }
+  return false;
+}
@@ -2,9 +2,32 @@
 #define CSV_PARSER_H
 #include <vector>
 #include <string>
+#include <istream>
+#include <string_view>
 
 std::vector<std::string> parseCSVLine(const std::string& line);
 std::vector<std::vector<std::string>> parseCSV(const std::string& data);
 
+// Reads records one at a time from a stream or an in-memory buffer with the
+// same RFC 4180 rules as parseCSV (quoted cells may span lines, blank lines
+// are skipped), so inputs can be processed row by row without materialising
+// every record.  A buffer passed as string_view must outlive the reader.
+class CsvRecordReader{
+public:
+  explicit CsvRecordReader(std::istream& in, size_t bufferSize=1<<16);
+  explicit CsvRecordReader(std::string_view data);
+  // Replaces `row` with the next record; false once the input is exhausted.
+  bool next(std::vector<std::string>& row);
+private:
+  int get(){ return (pos_<end_ || fill()) ? static_cast<unsigned char>(data_[pos_++]) : -1; }
+  int peek(){ return (pos_<end_ || fill()) ? static_cast<unsigned char>(data_[pos_]) : -1; }
+  bool fill();
+  std::istream* in_=nullptr;
+  std::vector<char> buf_;
+  const char* data_=nullptr;
+  size_t pos_=0;
+  size_t end_=0;
+};
+
 #endif
 
@@ -12,36 +12,39 @@ static std::string sanitizeFormulaCell(const std::string& cell) {
   return cell;
 }
 
-std::string serializeToCSV(const std::vector<std::vector<std::string>>& data) {
-  std::string result;
-  for(const auto& row : data) {
-    bool isEmptyRow = true;
-    for(const auto& cell : row) {
-      if(!cell.empty()) {
-        isEmptyRow = false;
-        break;
-      }
+bool appendCSVRow(std::string& out, const std::vector<std::string>& row) {
+  bool isEmptyRow = true;
+  for(const auto& cell : row) {
+    if(!cell.empty()) {
+      isEmptyRow = false;
+      break;
     }
-    if(isEmptyRow) continue;
+  }
+  if(isEmptyRow) return false;
 
-    for(size_t j = 0; j < row.size(); j++) {
-      if(j > 0) result += ",";
-      std::string safe = sanitizeFormulaCell(row[j]);
-      bool needsQuote = safe.find(',') != std::string::npos ||
-                        safe.find('"') != std::string::npos ||
-                        safe.find('\n') != std::string::npos;
-      if(needsQuote) {
-        result += "\"";
-        for(char c : safe) {
-          if(c == '"') result += "\"\"";
-          else result += c;
-        }
-        result += "\"";
-      } else {
-        result += safe;
+  for(size_t j = 0; j < row.size(); j++) {
+    if(j > 0) out += ",";
+    std::string safe = sanitizeFormulaCell(row[j]);
+    bool needsQuote = safe.find(',') != std::string::npos ||
+                      safe.find('"') != std::string::npos ||
+                      safe.find('\n') != std::string::npos;
+    if(needsQuote) {
+      out += "\"";
+      for(char c : safe) {
+        if(c == '"') out += "\"\"";
+        else out += c;
       }
+      out += "\"";
+    } else {
+      out += safe;
     }
-    result += "\r\n";
   }
+  out += "\r\n";
+  return true;
+}
+
+std::string serializeToCSV(const std::vector<std::vector<std::string>>& data) {
+  std::string result;
+  for(const auto& row : data) appendCSVRow(result, row);
   return result;
 }
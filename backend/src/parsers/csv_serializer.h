@@ -4,5 +4,9 @@
 #include <string>
 
 std::string serializeToCSV(const std::vector<std::vector<std::string>>& data);
+// Appends one serialized row (with its CRLF) to `out`, applying the same
+// formula-injection guard and quoting as serializeToCSV.  Rows whose cells
+// are all empty are skipped; returns whether the row was written.
+bool appendCSVRow(std::string& out, const std::vector<std::string>& row);
 
 #endif
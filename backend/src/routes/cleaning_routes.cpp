@@ -8,6 +8,8 @@
 #include "find_replace_rules.h"
 #include "cluster_detection.h"
 #include "csv_serializer.h"
+#include "reference_dictionary.h"
+#include "imputation.h"
 
 void registerCleaningRoutes(crow::SimpleApp& app){
   CROW_ROUTE(app,"/api/standardise-nulls").methods("POST"_method)
@@ -18,9 +20,11 @@ void registerCleaningRoutes(crow::SimpleApp& app){
     if (!tryAcquireConnection(clientIp)) return crow::response(429, "Too many concurrent requests from your IP");
     ConnectionGuard connGuard(clientIp);
     auto parsed=parseCSV(req.body);
-    auto cleaned=standardiseNullValuesInData(parsed);
+    MissingValueMap missing;
+    auto cleaned=standardiseNullValuesInData(parsed,&missing);
     crow::json::wvalue result;
     result["message"]="Null values standardised";
+    result["missingCount"]=(int)missing.total();
     logRequest("POST", "/api/standardise-nulls", 200);
     return crow::response(result);
   });
@@ -32,8 +36,14 @@ void registerCleaningRoutes(crow::SimpleApp& app){
     if (!tryAcquireConnection(clientIp)) return crow::response(429, "Too many concurrent requests from your IP");
     ConnectionGuard connGuard(clientIp);
     auto parsed=parseCSV(req.body);
-    auto deduped=fuzzyDeduplicateRows(parsed,threshold);
+    // ?mode=exhaustive compares every pair (small inputs only); the default
+    // compares sorted-neighbourhood candidates
+    const char* modeParam=req.url_params.get("mode");
+    bool exhaustive=modeParam && std::string(modeParam)=="exhaustive";
+    auto deduped=fuzzyDeduplicateRows(parsed,threshold,
+      exhaustive?FuzzyDedupMode::EXHAUSTIVE:FuzzyDedupMode::BLOCKED);
     crow::json::wvalue result;
+    result["mode"]=exhaustive?"exhaustive":"blocked";
     result["originalRows"]=(int)parsed.size();
     result["deduplicatedRows"]=(int)deduped.size();
     result["merged"]=(int)(parsed.size()-deduped.size());
@@ -62,7 +72,12 @@ void registerCleaningRoutes(crow::SimpleApp& app){
         rules.push_back(rule);
       }
       std::vector<std::string> headers=parsed.empty()?std::vector<std::string>():parsed[0];
-      auto frResult=applyFindReplace(parsed,column,rules,headers);
+      // "parallel": true splits rows across worker threads and rewrites the
+      // parsed table in place instead of copying it
+      bool parallel=json.has("parallel") && json["parallel"].b();
+      auto frResult=parallel
+        ? applyFindReplaceParallel(std::move(parsed),column,rules,headers)
+        : applyFindReplace(parsed,column,rules,headers);
       std::string csvStr=serializeToCSV(frResult.data);
       crow::json::wvalue resp;
       resp["csvData"]=csvStr;
@@ -74,6 +89,81 @@ void registerCleaningRoutes(crow::SimpleApp& app){
       return crow::response(400);
     }
   });
+  CROW_ROUTE(app,"/api/standardise-reference").methods("POST"_method)
+  ([](const crow::request& req){
+    const std::string clientIp = resolveClientIp(req.get_header_value("x-forwarded-for"), req.remote_ip_address);
+    if (!checkRateLimit(clientIp)) {logRequest("POST", "/api/standardise-reference", 429); return crow::response(429);}
+    if (req.body.size() > 50 * 1024 * 1024) return crow::response(413, "Payload too large. Maximum 50MB.");
+    if (!tryAcquireConnection(clientIp)) return crow::response(429, "Too many concurrent requests from your IP");
+    ConnectionGuard connGuard(clientIp);
+    try {
+      auto json=crow::json::load(req.body);
+      std::string csvData=json["csvData"].s();
+      std::string column=json["column"].s();
+      // referenceCsv: header, then canonical value and its variants per row;
+      // the built dictionary is shared with every request sending the same list
+      auto dictionary=sharedReferenceDictionary(json["referenceCsv"].s());
+      int maxEdits=json.has("maxEdits")?(int)json["maxEdits"].i():-1;
+      auto stResult=standardiseToReference(parseCSV(csvData),column,*dictionary,maxEdits);
+      crow::json::wvalue resp;
+      resp["csvData"]=serializeToCSV(stResult.data);
+      resp["cellsChanged"]=stResult.cellsChanged;
+      resp["exactMatches"]=stResult.exactMatches;
+      resp["prefixMatches"]=stResult.prefixMatches;
+      resp["fuzzyMatches"]=stResult.fuzzyMatches;
+      resp["unmatched"]=stResult.unmatched;
+      logRequest("POST", "/api/standardise-reference", 200);
+      return crow::response(resp);
+    } catch(...) {
+      logRequest("POST", "/api/standardise-reference", 400);
+      return crow::response(400);
+    }
+  });
+  CROW_ROUTE(app,"/api/impute").methods("POST"_method)
+  ([](const crow::request& req){
+    const std::string clientIp = resolveClientIp(req.get_header_value("x-forwarded-for"), req.remote_ip_address);
+    if (!checkRateLimit(clientIp)) {logRequest("POST", "/api/impute", 429); return crow::response(429);}
+    if (req.body.size() > 50 * 1024 * 1024) return crow::response(413, "Payload too large. Maximum 50MB.");
+    if (!tryAcquireConnection(clientIp)) return crow::response(429, "Too many concurrent requests from your IP");
+    ConnectionGuard connGuard(clientIp);
+    try {
+      auto json=crow::json::load(req.body);
+      ImputeOptions options;
+      if(json.has("numeric")&&!parseNumericImpute(json["numeric"].s(),options.numeric)){
+        logRequest("POST", "/api/impute", 400);
+        return crow::response(400, "numeric must be mean, median or mode");
+      }
+      if(json.has("categorical")&&!parseCategoricalImpute(json["categorical"].s(),options.categorical)){
+        logRequest("POST", "/api/impute", 400);
+        return crow::response(400, "categorical must be mode or dummy");
+      }
+      if(json.has("dummyValue")) options.dummyValue=json["dummyValue"].s();
+      if(json.has("columns")) for(auto& c:json["columns"]) options.columns.push_back(c.s());
+      auto parsed=parseCSV(json["csvData"].s());
+      // fitCsv: fill from another table's statistics (a test split imputed
+      // with its training split's mean/median/mode)
+      auto imputed=json.has("fitCsv")
+        ? applyImputation(std::move(parsed),fitImputation(parseCSV(json["fitCsv"].s()),options))
+        : imputeMissingValues(std::move(parsed),options);
+      crow::json::wvalue resp;
+      resp["csvData"]=serializeToCSV(imputed.data);
+      resp["cellsFilled"]=(int)imputed.cellsFilled;
+      resp["columns"]=crow::json::wvalue::list();
+      for(size_t i=0;i<imputed.columns.size();i++){
+        const auto& c=imputed.columns[i];
+        resp["columns"][i]["name"]=c.name;
+        resp["columns"][i]["type"]=columnTypeToString(c.type);
+        resp["columns"][i]["numeric"]=c.numeric;
+        resp["columns"][i]["fillValue"]=c.fillValue;
+        resp["columns"][i]["filled"]=(int)c.filled;
+      }
+      logRequest("POST", "/api/impute", 200);
+      return crow::response(resp);
+    } catch(...) {
+      logRequest("POST", "/api/impute", 400);
+      return crow::response(400);
+    }
+  });
   CROW_ROUTE(app,"/api/detect-clusters").methods("POST"_method)
   ([](const crow::request& req){
     const std::string clientIp = resolveClientIp(req.get_header_value("x-forwarded-for"), req.remote_ip_address);
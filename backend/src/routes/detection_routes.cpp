@@ -2,9 +2,12 @@
 #include "csv_parser.h"
 #include "text_normalisation.h"
 #include "string_issue_detectors.h"
+#include "quantile_sketch.h"
+#include "missing_values.h"
 #include "structural_cleaners.h"
 #include "logger.h"
 #include "rate_limiter.h"
+#include <cstdlib>
 
 std::string toCSV(const std::vector<std::vector<std::string>>& data){
   std::string result;
@@ -29,6 +32,19 @@ std::string toCSV(const std::vector<std::vector<std::string>>& data){
   return result;
 }
 
+// ?method=iqr|zscore|modified-zscore|percentile&threshold=t; false if either is malformed.
+static bool outlierOptionsFromQuery(const crow::request& req, OutlierOptions& options){
+  const char* method=req.url_params.get("method");
+  if(method&&!parseOutlierMethod(method,options.method)) return false;
+  const char* threshold=req.url_params.get("threshold");
+  if(threshold){
+    char* end=nullptr;
+    options.threshold=std::strtod(threshold,&end);
+    if(end==threshold||*end!='\0'||!(options.threshold>0)) return false;
+  }
+  return true;
+}
+
 void registerAdditionalRoutes(crow::SimpleApp& app){
   CROW_ROUTE(app,"/api/detect-outliers").methods("POST"_method)
   ([](const crow::request& req){
@@ -37,9 +53,21 @@ void registerAdditionalRoutes(crow::SimpleApp& app){
     if (req.body.size() > 50 * 1024 * 1024) return crow::response(413, "Payload too large. Maximum 50MB.");
     if (!tryAcquireConnection(clientIp)) return crow::response(429, "Too many concurrent requests from your IP");
     ConnectionGuard connGuard(clientIp);
-    auto parsed=parseCSV(req.body);
-    auto outliers=detectOutliers(parsed);
+    OutlierOptions options;
+    if(!outlierOptionsFromQuery(req,options)){logRequest("POST", "/api/detect-outliers", 400); return crow::response(400, "Invalid outlier method or threshold");}
     crow::json::wvalue resp;
+    auto mode=req.url_params.get("mode");
+    if(mode&&std::string(mode)=="sketch"){
+      if(options.method!=OutlierMethod::IQR||options.threshold>0){logRequest("POST", "/api/detect-outliers", 400); return crow::response(400, "Sketch mode supports the default IQR fences only");}
+      // two passes over the body with per-column quantile sketches; no table in memory
+      auto flagged=detectOutliersStreaming(req.body);
+      resp["outlierCount"]=(int)flagged.count();
+      resp["mode"]="sketch";
+      logRequest("POST", "/api/detect-outliers", 200);
+      return crow::response(resp);
+    }
+    auto parsed=parseCSV(req.body);
+    auto outliers=detectOutliers(parsed,options);
     resp["outlierCount"]=(int)outliers.size();
     logRequest("POST", "/api/detect-outliers", 200);
     return crow::response(resp);
@@ -51,13 +79,27 @@ void registerAdditionalRoutes(crow::SimpleApp& app){
     if (req.body.size() > 50 * 1024 * 1024) return crow::response(413, "Payload too large. Maximum 50MB.");
     if (!tryAcquireConnection(clientIp)) return crow::response(429, "Too many concurrent requests from your IP");
     ConnectionGuard connGuard(clientIp);
-    auto parsed=parseCSV(req.body);
-    auto missing=detectMissingValues(parsed);
-    int count=0;
-    for(const auto& row:missing)
-      for(bool m:row) if(m) count++;
+    // the map is filled record by record as the body is parsed; the table
+    // itself is never built
+    CsvRecordReader reader{std::string_view(req.body)};
+    std::vector<std::string> header,row;
+    MissingValueMap missing;
+    if(reader.next(header)){
+      missing=MissingValueMap(header.size());
+      missing.addRow(header);
+      while(reader.next(row)) missing.addRow(row);
+    }
     crow::json::wvalue result;
-    result["missingCount"]=count;
+    result["missingCount"]=(int)missing.total();
+    result["columns"]=crow::json::wvalue::list();
+    for(size_t c=0;c<missing.columns();c++){
+      result["columns"][c]["name"]=header[c];
+      result["columns"][c]["missing"]=(int)missing.columnCount(c);
+    }
+    // one count per data row (the header is left out)
+    auto perRow=missing.rowCounts();
+    std::vector<int> rowCounts(perRow.size()>1?perRow.begin()+1:perRow.end(),perRow.end());
+    result["rowMissingCounts"]=rowCounts;
     logRequest("POST", "/api/detect-missing", 200);
     return crow::response(result);
   });
@@ -71,7 +113,7 @@ void registerAdditionalRoutes(crow::SimpleApp& app){
     auto json=crow::json::load(req.body);
     std::string csvData=json["csvData"].s();
     auto parsed=parseCSV(csvData);
-    auto normalized=trimWhitespace(parsed);
+    auto normalized=trimWhitespace(std::move(parsed));
     crow::json::wvalue result;
     result["csvData"]=toCSV(normalized);
     result["message"]="Whitespace normalised";
@@ -103,9 +145,22 @@ void registerAdditionalRoutes(crow::SimpleApp& app){
     if (req.body.size() > 50 * 1024 * 1024) return crow::response(413, "Payload too large. Maximum 50MB.");
     if (!tryAcquireConnection(clientIp)) return crow::response(429, "Too many concurrent requests from your IP");
     ConnectionGuard connGuard(clientIp);
-    auto parsed=parseCSV(req.body);
-    auto cleaned=removeOutliers(parsed);
+    OutlierOptions options;
+    if(!outlierOptionsFromQuery(req,options)){logRequest("POST", "/api/remove-outliers", 400); return crow::response(400, "Invalid outlier method or threshold");}
     crow::json::wvalue result;
+    auto mode=req.url_params.get("mode");
+    if(mode&&std::string(mode)=="sketch"){
+      if(options.method!=OutlierMethod::IQR||options.threshold>0){logRequest("POST", "/api/remove-outliers", 400); return crow::response(400, "Sketch mode supports the default IQR fences only");}
+      auto flagged=detectOutliersStreaming(req.body);
+      result["originalRows"]=(int)flagged.size();
+      result["cleanedRows"]=(int)(flagged.size()-flagged.count());
+      result["outliersRemoved"]=(int)flagged.count();
+      result["mode"]="sketch";
+      logRequest("POST", "/api/remove-outliers", 200);
+      return crow::response(result);
+    }
+    auto parsed=parseCSV(req.body);
+    auto cleaned=removeOutliers(parsed,options);
     result["originalRows"]=(int)parsed.size();
     result["cleanedRows"]=(int)cleaned.size();
     result["outliersRemoved"]=(int)(parsed.size()-cleaned.size());
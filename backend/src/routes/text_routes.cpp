@@ -2,6 +2,7 @@
 #include "csv_parser.h"
 #include "text_normalisation.h"
 #include "structural_cleaners.h"
+#include "csv_serializer.h"
 #include "logger.h"
 #include "rate_limiter.h"
 
@@ -53,11 +54,14 @@ void registerTextRoutes(crow::SimpleApp& app){
     if (req.body.size() > 50 * 1024 * 1024) return crow::response(413, "Payload too large. Maximum 50MB.");
     if (!tryAcquireConnection(clientIp)) return crow::response(429, "Too many concurrent requests from your IP");
     ConnectionGuard connGuard(clientIp);
+    // always in memory: the body already is, and spilling uploaded rows to
+    // temp files would put them on disk (--batch-sort is the offline path)
     auto parsed=parseCSV(req.body);
-    auto sorted=naturalSort(parsed,colIndex);
+    auto sorted=naturalSort(std::move(parsed),colIndex);
     crow::json::wvalue result;
     result["message"]="Data sorted naturally";
     result["rows"]=(int)sorted.size();
+    result["csvData"]=serializeToCSV(sorted);
     logRequest("POST", "/api/natural-sort", 200);
     return crow::response(result);
   });
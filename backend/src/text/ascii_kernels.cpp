@@ -0,0 +1,186 @@
+#include "ascii_kernels.h"
+#include "char_class.h"
+#include "bitmap.h"
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define ASCII_SSE2 1
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define ASCII_AVX2 1
+#endif
+
+// --- ASCII check -----------------------------------------------------------
+
+bool isAscii(const char* p, size_t n) {
+  size_t i = 0;
+#ifdef ASCII_AVX2
+  for (; i + 32 <= n; i += 32)
+    if (_mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i))) != 0) return false;
+#endif
+#ifdef ASCII_SSE2
+  // OR four blocks together so the branch is taken once per 64 bytes
+  for (; i + 64 <= n; i += 64) {
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i + 16));
+    __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i + 32));
+    __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i + 48));
+    if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d))) != 0) return false;
+  }
+  for (; i + 16 <= n; i += 16)
+    if (_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i))) != 0) return false;
+#endif
+  for (; i < n; i++)
+    if (static_cast<unsigned char>(p[i]) >= 0x80) return false;
+  return true;
+}
+
+// --- case mapping ----------------------------------------------------------
+
+// Flips bit 0x20 of the bytes in [lo, hi].  The compares are signed, so
+// bytes >= 0x80 read as negative and are never in range.
+#ifdef ASCII_SSE2
+static inline __m128i flipCase16(__m128i v, char lo, char hi) {
+  __m128i in = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(static_cast<char>(lo - 1))),
+                             _mm_cmplt_epi8(v, _mm_set1_epi8(static_cast<char>(hi + 1))));
+  return _mm_xor_si128(v, _mm_and_si128(in, _mm_set1_epi8(0x20)));
+}
+#endif
+#ifdef ASCII_AVX2
+static inline __m256i flipCase32(__m256i v, char lo, char hi) {
+  __m256i in = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(static_cast<char>(lo - 1))),
+                                _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(hi + 1)), v));
+  return _mm256_xor_si256(v, _mm256_and_si256(in, _mm256_set1_epi8(0x20)));
+}
+#endif
+
+static void flipCase(char* p, size_t n, char lo, char hi) {
+  size_t i = 0;
+#ifdef ASCII_AVX2
+  for (; i + 32 <= n; i += 32) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p + i), flipCase32(v, lo, hi));
+  }
+#endif
+#ifdef ASCII_SSE2
+  for (; i + 16 <= n; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p + i), flipCase16(v, lo, hi));
+  }
+#endif
+  for (; i < n; i++)
+    if (p[i] >= lo && p[i] <= hi) p[i] = static_cast<char>(p[i] ^ 0x20);
+}
+
+void asciiToUpper(char* p, size_t n) { flipCase(p, n, 'a', 'z'); }
+void asciiToLower(char* p, size_t n) { flipCase(p, n, 'A', 'Z'); }
+
+// --- blank classification --------------------------------------------------
+
+#ifdef ASCII_SSE2
+static inline __m128i blankBytes16(__m128i v) {
+  __m128i sp = _mm_cmpeq_epi8(v, _mm_set1_epi8(' '));
+  __m128i tab = _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'));
+  __m128i cr = _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'));
+  __m128i lf = _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'));
+  return _mm_or_si128(_mm_or_si128(sp, tab), _mm_or_si128(cr, lf));
+}
+#endif
+#ifdef ASCII_AVX2
+static inline __m256i blankBytes32(__m256i v) {
+  __m256i sp = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' '));
+  __m256i tab = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'));
+  __m256i cr = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r'));
+  __m256i lf = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'));
+  return _mm256_or_si256(_mm256_or_si256(sp, tab), _mm256_or_si256(cr, lf));
+}
+#endif
+
+uint32_t blankMask16(const char* p) {
+#ifdef ASCII_SSE2
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  return static_cast<uint32_t>(_mm_movemask_epi8(blankBytes16(v)));
+#else
+  uint32_t mask = 0;
+  for (int i = 0; i < 16; i++)
+    if (isCharClass(p[i], CC_BLANK)) mask |= 1u << i;
+  return mask;
+#endif
+}
+
+// --- collapse and trim -----------------------------------------------------
+
+namespace {
+// Output position and whether the last byte seen was blank.  Starting as
+// "blank" drops leading blanks; a pending space at the end is taken back.
+struct CollapseState {
+  char* dst;
+  size_t out = 0;
+  bool prevBlank = true;
+};
+}
+
+// One block of `width` (at most 32) bytes with known blank and space masks.
+// A blank that starts a run is kept, as ' ', and the rest of the run is
+// dropped.  Returns false, writing nothing, for the common block that needs
+// no change (single spaces only); the caller stores it whole.
+static bool compressBlock(const char* block, unsigned width, uint64_t blank, uint64_t space,
+                          CollapseState& s) {
+  const uint64_t full = (uint64_t(1) << width) - 1;
+  const uint64_t starts = blank & ~((blank << 1) | (s.prevBlank ? 1 : 0)) & full;
+  const uint64_t drop = blank & ~starts;
+  s.prevBlank = (blank >> (width - 1)) & 1;
+  if (drop == 0 && (starts & ~space) == 0) return false;
+  // compress: walk the kept bytes by bit index
+  for (uint64_t keep = ~drop & full; keep != 0; keep &= keep - 1) {
+    unsigned j = lowestSetBit(keep);
+    s.dst[s.out++] = (starts >> j) & 1 ? ' ' : block[j];
+  }
+  return true;
+}
+
+size_t collapseBlanks(const char* src, size_t n, char* dst) {
+  CollapseState s;
+  s.dst = dst;
+  size_t i = 0;
+  // Each block is loaded before anything is stored, and stores land at
+  // s.out <= i, so collapsing in place never overwrites unread bytes.
+#ifdef ASCII_AVX2
+  for (; i + 32 <= n; i += 32) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    uint64_t blank = static_cast<uint32_t>(_mm256_movemask_epi8(blankBytes32(v)));
+    uint64_t space = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' '))));
+    alignas(32) char block[32];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(block), v);
+    if (!compressBlock(block, 32, blank, space, s)) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + s.out), v);
+      s.out += 32;
+    }
+  }
+#endif
+#ifdef ASCII_SSE2
+  for (; i + 16 <= n; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    uint64_t blank = static_cast<uint32_t>(_mm_movemask_epi8(blankBytes16(v)));
+    uint64_t space = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(' '))));
+    alignas(16) char block[16];
+    _mm_store_si128(reinterpret_cast<__m128i*>(block), v);
+    if (!compressBlock(block, 16, blank, space, s)) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + s.out), v);
+      s.out += 16;
+    }
+  }
+#endif
+  for (; i < n; i++) {
+    char c = src[i];
+    if (isCharClass(c, CC_BLANK)) {
+      if (!s.prevBlank) dst[s.out++] = ' ';
+      s.prevBlank = true;
+    } else {
+      dst[s.out++] = c;
+      s.prevBlank = false;
+    }
+  }
+  if (s.prevBlank && s.out > 0) s.out--;
+  return s.out;
+}
@@ -0,0 +1,30 @@
+#ifndef ASCII_KERNELS_H
+#define ASCII_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Byte-parallel versions of the per-cell ASCII loops: case mapping and
+// blank-run collapse.  16 bytes at a time with SSE2, 32 with AVX2 when the
+// build targets it (-mavx2 / -march=native), and a scalar loop otherwise
+// and for the tail.  All of them agree byte for byte with the CHAR_TABLE
+// mappings in char_class.h: bytes >= 0x80 are never changed, and "blank"
+// means space, tab, CR or LF.
+
+// True when no byte of p[0, n) has the high bit set, i.e. the text is
+// plain ASCII and the byte kernels below are exact on it.
+bool isAscii(const char* p, size_t n);
+
+// In-place ASCII case mapping of p[0, n).
+void asciiToUpper(char* p, size_t n);
+void asciiToLower(char* p, size_t n);
+
+// Bit i set when p[i] is blank, for the 16 bytes at p.
+uint32_t blankMask16(const char* p);
+
+// Writes src[0, n) to dst with leading and trailing blanks dropped and each
+// interior blank run replaced by a single space; returns the length written
+// (at most n).  dst may equal src, so a string can be collapsed in place.
+size_t collapseBlanks(const char* src, size_t n, char* dst);
+
+#endif
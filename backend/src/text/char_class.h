@@ -0,0 +1,60 @@
+#ifndef CHAR_CLASS_H
+#define CHAR_CLASS_H
+
+#include <cstdint>
+
+// Byte classification and ASCII case mapping as 256-entry tables built at
+// compile time.  Every per-cell loop (type validators, per-type normalisers,
+// comparison keys) does one load per byte instead of a chain of range tests.
+// Bytes >= 0x80 carry no class and map to themselves, which matches
+// ::tolower/::toupper and isspace() in the C locale.
+
+enum CharClass : uint8_t {
+  CC_DIGIT    = 1 << 0,
+  CC_ALPHA    = 1 << 1,
+  CC_PHONE    = 1 << 2,  // digits and the separators a phone may contain: space - . ( ) +
+  CC_ID       = 1 << 3,  // letters, digits, - and _
+  CC_NAME     = 1 << 4,  // letters, space, and the - ' . a name may contain
+  CC_SENTENCE = 1 << 5,  // . ! ? , ; :
+  CC_CSPACE   = 1 << 6,  // isspace() in the C locale
+  CC_BLANK    = 1 << 7   // space, tab, CR, LF: what cells are trimmed of
+};
+
+struct CharClassTable {
+  uint8_t cls[256];
+  char lower[256];
+  char upper[256];
+};
+
+constexpr CharClassTable makeCharClassTable() {
+  CharClassTable t{};
+  for (int c = 0; c < 256; c++) {
+    uint8_t f = 0;
+    bool upper = c >= 'A' && c <= 'Z';
+    bool lower = c >= 'a' && c <= 'z';
+    bool alpha = upper || lower;
+    bool digit = c >= '0' && c <= '9';
+    if (digit) f |= CC_DIGIT;
+    if (alpha) f |= CC_ALPHA;
+    if (digit || c == ' ' || c == '-' || c == '.' || c == '(' || c == ')' || c == '+')
+      f |= CC_PHONE;
+    if (alpha || digit || c == '-' || c == '_') f |= CC_ID;
+    if (alpha || c == ' ' || c == '-' || c == '\'' || c == '.') f |= CC_NAME;
+    if (c == '.' || c == '!' || c == '?' || c == ',' || c == ';' || c == ':') f |= CC_SENTENCE;
+    if (c == ' ' || (c >= '\t' && c <= '\r')) f |= CC_CSPACE;
+    if (c == ' ' || c == '\t' || c == '\r' || c == '\n') f |= CC_BLANK;
+    t.cls[c] = f;
+    t.lower[c] = static_cast<char>(upper ? c + 32 : c);
+    t.upper[c] = static_cast<char>(lower ? c - 32 : c);
+  }
+  return t;
+}
+
+inline constexpr CharClassTable CHAR_TABLE = makeCharClassTable();
+
+inline uint8_t charClass(char c) { return CHAR_TABLE.cls[static_cast<unsigned char>(c)]; }
+inline bool isCharClass(char c, uint8_t mask) { return (charClass(c) & mask) != 0; }
+inline char lowerChar(char c) { return CHAR_TABLE.lower[static_cast<unsigned char>(c)]; }
+inline char upperChar(char c) { return CHAR_TABLE.upper[static_cast<unsigned char>(c)]; }
+
+#endif
@@ -0,0 +1,82 @@
+#include "null_tokens.h"
+#include "char_class.h"
+#include "perfect_hash.h"
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+
+// Keys are stored in lookup form: upper case, single interior spaces.
+static constexpr KeywordEntry<bool> BUILTIN_TOKENS[] = {
+  {"N/A", true}, {"NA", true}, {"NULL", true}, {"NONE", true}, {"NIL", true}, {"MISSING", true},
+  {"NAN", true}, {"UNDEFINED", true}, {"-", true}, {"--", true}, {"?", true}, {"~", true},
+};
+static constexpr auto BUILTIN_NULL_TOKENS = makePerfectHash<bool, 32>(BUILTIN_TOKENS);
+static_assert(BUILTIN_NULL_TOKENS.maxKeyLength() <= MAX_NULL_TOKEN_LENGTH, "token buffer too small");
+
+// Built-in and custom tokens together, once custom tokens are configured.
+static std::unique_ptr<const KeywordSet> customTokens;
+
+// Writes the lookup form of `cell` to key[0, limit) and returns its length,
+// or limit + 1 once it is known not to fit.
+static size_t lookupForm(std::string_view cell, char* key, size_t limit) {
+  size_t b = 0, e = cell.size();
+  while (b < e && isCharClass(cell[b], CC_BLANK)) b++;
+  while (e > b && isCharClass(cell[e - 1], CC_BLANK)) e--;
+  size_t len = 0;
+  bool inBlank = false;
+  for (size_t i = b; i < e; i++) {
+    if (isCharClass(cell[i], CC_BLANK)) { inBlank = true; continue; }
+    if (len + inBlank >= limit) return limit + 1;
+    if (inBlank) key[len++] = ' ';
+    key[len++] = upperChar(cell[i]);
+    inBlank = false;
+  }
+  return len;
+}
+
+bool isNullToken(std::string_view cell) {
+  char key[MAX_NULL_TOKEN_LENGTH];
+  const KeywordSet* custom = customTokens.get();
+  const size_t limit = custom ? custom->maxKeyLength() : BUILTIN_NULL_TOKENS.maxKeyLength();
+  const size_t len = lookupForm(cell, key, limit);
+  if (len == 0) return true;
+  if (len > limit) return false;
+  std::string_view k(key, len);
+  return custom ? custom->contains(k) : BUILTIN_NULL_TOKENS.contains(k);
+}
+
+bool setCustomNullTokens(const std::vector<std::string>& tokens, std::string* error) {
+  std::vector<std::string> keys;
+  for (const auto& entry : BUILTIN_TOKENS) keys.emplace_back(entry.key);
+  char key[MAX_NULL_TOKEN_LENGTH];
+  for (const auto& token : tokens) {
+    size_t len = lookupForm(token, key, MAX_NULL_TOKEN_LENGTH);
+    if (len > MAX_NULL_TOKEN_LENGTH) {
+      if (error) *error = "null token longer than " + std::to_string(MAX_NULL_TOKEN_LENGTH) + " bytes: " + token;
+      return false;
+    }
+    if (len > 0) keys.emplace_back(key, len);
+  }
+  try {
+    customTokens = std::make_unique<const KeywordSet>(std::move(keys));
+  } catch (const std::length_error&) {
+    if (error) *error = "too many null tokens (at most " + std::to_string(KeywordSet::MAX_KEYS) + ")";
+    return false;
+  }
+  return true;
+}
+
+std::vector<std::string> nullTokensFromEnvironment() {
+  std::vector<std::string> tokens;
+  const char* env = std::getenv("TOOLKIT_NULL_TOKENS");
+  if (!env) return tokens;
+  std::string_view list(env);
+  while (!list.empty()) {
+    size_t comma = list.find(',');
+    std::string_view token = list.substr(0, comma);
+    if (!token.empty()) tokens.emplace_back(token);
+    if (comma == std::string_view::npos) break;
+    list.remove_prefix(comma + 1);
+  }
+  return tokens;
+}
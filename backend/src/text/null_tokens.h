@@ -0,0 +1,29 @@
+#ifndef NULL_TOKENS_H
+#define NULL_TOKENS_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Recognises the placeholders exports use for a missing value ("N/A",
+// "null", "-", ...).  A cell matches when, with blanks trimmed, interior
+// blank runs collapsed to one space and ASCII letters upper-cased, it is one
+// of the tokens; blank cells match too.  The check runs on the cell's own
+// bytes through a stack buffer: no allocation, and work bounded by the
+// longest token however long the cell is.
+//
+// Built in: N/A NA NULL NONE NIL MISSING NAN UNDEFINED - -- ? ~
+bool isNullToken(std::string_view cell);
+
+// Adds deployment-specific tokens to the built-in ones (normalised the same
+// way; tokens longer than MAX_NULL_TOKEN_LENGTH are rejected).  Not thread
+// safe: call at startup, before any request is served.  Returns false, and
+// keeps the current tokens, if the list is invalid; `error` says why.
+static const size_t MAX_NULL_TOKEN_LENGTH = 64;
+bool setCustomNullTokens(const std::vector<std::string>& tokens, std::string* error = nullptr);
+
+// Comma-separated tokens from TOOLKIT_NULL_TOKENS, e.g. "unknown,#N/A,-999";
+// empty when the variable is unset.
+std::vector<std::string> nullTokensFromEnvironment();
+
+#endif
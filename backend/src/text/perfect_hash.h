@@ -0,0 +1,155 @@
+#ifndef PERFECT_HASH_H
+#define PERFECT_HASH_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Collision-free lookup table over a fixed keyword set, built at compile time.
+// The constructor searches for a hash seed under which every keyword lands in
+// its own slot, so a lookup is one hash, one slot load and one compare — no
+// allocation, no probing.  Keys are matched byte-for-byte; callers fold case
+// before looking up.
+//
+//   static constexpr auto WORDS = makePerfectHash<int, 64>({{"yes", 1}, {"no", 0}});
+//   WORDS.find("yes", -1);  // 1
+//
+// Before hashing, a lookup tests the key's length against a bitmask of the
+// keyword lengths, so most non-keywords are rejected without reading a byte.
+
+// FNV-1a seeded with the search result, folded so short keys still spread
+// across the high slot bits.  `slots` is a power of two.
+constexpr size_t perfectHashSlot(std::string_view key, uint32_t seed, size_t slots) {
+  uint32_t h = 2166136261u ^ seed;
+  for (char c : key) h = (h ^ static_cast<unsigned char>(c)) * 16777619u;
+  h ^= h >> 15;
+  return h & (slots - 1);
+}
+
+// Bit min(length, 63): lengths of 63 and up share the top bit.
+constexpr uint64_t keyLengthBit(size_t length) { return uint64_t(1) << (length < 63 ? length : 63); }
+
+template <typename Value>
+struct KeywordEntry {
+  std::string_view key;
+  Value value;
+};
+
+template <typename Value, size_t N, size_t Slots>
+class PerfectHashTable {
+  static_assert((Slots & (Slots - 1)) == 0, "slot count must be a power of two");
+  static_assert(N < Slots && Slots <= 256, "keywords must fit in uint8_t slots");
+
+public:
+  constexpr explicit PerfectHashTable(const KeywordEntry<Value> (&entries)[N]) {
+    for (size_t i = 0; i < N; i++) {
+      entries_[i] = entries[i];
+      lengths_ |= keyLengthBit(entries[i].key.size());
+      if (entries[i].key.size() > maxKeyLength_) maxKeyLength_ = entries[i].key.size();
+    }
+    for (seed_ = 1;; seed_++) {
+      for (size_t s = 0; s < Slots; s++) slots_[s] = EMPTY;
+      bool collided = false;
+      for (size_t i = 0; i < N && !collided; i++) {
+        size_t s = slotOf(entries_[i].key);
+        if (slots_[s] != EMPTY) collided = true;
+        else slots_[s] = static_cast<uint8_t>(i);
+      }
+      if (!collided) break;
+    }
+  }
+
+  // Value for `key`, or `missing` if the key is not in the set.
+  constexpr Value find(std::string_view key, Value missing) const {
+    if (!(lengths_ & keyLengthBit(key.size()))) return missing;
+    uint8_t idx = slots_[slotOf(key)];
+    if (idx == EMPTY || entries_[idx].key != key) return missing;
+    return entries_[idx].value;
+  }
+
+  constexpr bool contains(std::string_view key) const {
+    if (!(lengths_ & keyLengthBit(key.size()))) return false;
+    uint8_t idx = slots_[slotOf(key)];
+    return idx != EMPTY && entries_[idx].key == key;
+  }
+
+  constexpr size_t maxKeyLength() const { return maxKeyLength_; }
+
+private:
+  static constexpr uint8_t EMPTY = 0xFF;
+
+  constexpr size_t slotOf(std::string_view key) const { return perfectHashSlot(key, seed_, Slots); }
+
+  KeywordEntry<Value> entries_[N] = {};
+  uint8_t slots_[Slots] = {};
+  uint32_t seed_ = 0;
+  size_t maxKeyLength_ = 0;
+  uint64_t lengths_ = 0;
+};
+
+template <typename Value, size_t Slots, size_t N>
+constexpr PerfectHashTable<Value, N, Slots> makePerfectHash(const KeywordEntry<Value> (&entries)[N]) {
+  return PerfectHashTable<Value, N, Slots>(entries);
+}
+
+// Run-time counterpart for keyword sets only known at startup (e.g. read
+// from configuration): the same seed search and one-compare lookup, over
+// owned copies of the keys.  The slot array grows with the square of the
+// key count so a collision-free seed turns up within a few tries; it holds
+// at most MAX_KEYS keys.
+class KeywordSet {
+public:
+  static constexpr size_t MAX_KEYS = 254;
+
+  KeywordSet() = default;
+
+  // Duplicate keys are dropped.  Throws std::length_error past MAX_KEYS.
+  explicit KeywordSet(std::vector<std::string> keys);
+
+  bool contains(std::string_view key) const {
+    if (!(lengths_ & keyLengthBit(key.size()))) return false;
+    uint8_t idx = slots_[perfectHashSlot(key, seed_, slots_.size())];
+    return idx != EMPTY && keys_[idx] == key;
+  }
+
+  size_t size() const { return keys_.size(); }
+  size_t maxKeyLength() const { return maxKeyLength_; }
+
+private:
+  static constexpr uint8_t EMPTY = 0xFF;
+
+  std::vector<std::string> keys_;
+  std::vector<uint8_t> slots_ = std::vector<uint8_t>(1, EMPTY);
+  uint32_t seed_ = 0;
+  size_t maxKeyLength_ = 0;
+  uint64_t lengths_ = 0;
+};
+
+inline KeywordSet::KeywordSet(std::vector<std::string> keys) {
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  if (keys.size() > MAX_KEYS) throw std::length_error("keyword set: more than 254 keys");
+  keys_ = std::move(keys);
+  size_t slots = 64;
+  while (slots < 2 * keys_.size() * keys_.size()) slots *= 2;
+  for (const auto& key : keys_) {
+    lengths_ |= keyLengthBit(key.size());
+    maxKeyLength_ = std::max(maxKeyLength_, key.size());
+  }
+  for (seed_ = 1;; seed_++) {
+    slots_.assign(slots, EMPTY);
+    bool collided = false;
+    for (size_t i = 0; i < keys_.size() && !collided; i++) {
+      uint8_t& slot = slots_[perfectHashSlot(keys_[i], seed_, slots)];
+      if (slot != EMPTY) collided = true;
+      else slot = static_cast<uint8_t>(i);
+    }
+    if (!collided) break;
+  }
+}
+
+#endif
@@ -1,37 +1,47 @@
 #include "text_normalisation.h"
+#include "ascii_kernels.h"
+#include "char_class.h"
+#include "null_tokens.h"
+#include "utf8.h"
 #include <algorithm>
 #include <sstream>
 
+// ASCII cells, nearly all of them, stay on the byte kernels; anything else
+// goes through the Unicode case tables, which may change its byte length.
 std::string toUpperCase(const std::string& text){
+  if(!isAscii(text.data(),text.size())) return utf8ToUpper(text);
   std::string result=text;
-  std::transform(result.begin(),result.end(),result.begin(),::toupper);
+  asciiToUpper(&result[0],result.size());
   return result;
 }
 
 std::string toLowerCase(const std::string& text){
+  if(!isAscii(text.data(),text.size())) return utf8ToLower(text);
   std::string result=text;
-  std::transform(result.begin(),result.end(),result.begin(),::tolower);
+  asciiToLower(&result[0],result.size());
   return result;
 }
 
+void toUpperCaseInPlace(std::string& text){
+  if(isAscii(text.data(),text.size())) asciiToUpper(&text[0],text.size());
+  else text=utf8ToUpper(text);
+}
+
+void toLowerCaseInPlace(std::string& text){
+  if(isAscii(text.data(),text.size())) asciiToLower(&text[0],text.size());
+  else text=utf8ToLower(text);
+}
+
 std::string normaliseWhitespace(const std::string& text){
-  std::string result;
-  bool inSpace=false;
-  for(char c : text){
-    if(c==' ' || c=='\t' || c=='\r' || c=='\n'){
-      if(!inSpace && !result.empty()){
-        result+=' ';
-        inSpace=true;
-      }
-    }else{
-      result+=c;
-      inSpace=false;
-    }
-  }
-  while(!result.empty() && result.back()==' ') result.pop_back();
+  std::string result(text.size(),'\0');
+  result.resize(collapseBlanks(text.data(),text.size(),&result[0]));
   return result;
 }
 
+void normaliseWhitespaceInPlace(std::string& text){
+  text.resize(collapseBlanks(text.data(),text.size(),&text[0]));
+}
+
 std::string normalisePunctuation(const std::string& text){
   std::string result;
   for(char c : text){
@@ -41,15 +51,6 @@ std::string normalisePunctuation(const std::string& text){
 }
 
 std::string standardiseNullValues(const std::string& text){
-  std::string trimmed=normaliseWhitespace(text);
-  if(trimmed.empty()) return "";
-  std::string upper=toUpperCase(trimmed);
-  if(upper=="N/A" || upper=="NA") return "";
-  if(upper=="NULL") return "";
-  if(upper=="NONE" || upper=="NIL") return "";
-  if(upper=="MISSING") return "";
-  if(upper=="NAN" || upper=="UNDEFINED") return "";
-  if(upper=="-" || upper=="--" || upper=="?" || upper=="~") return "";
-  return trimmed;
+  if(isNullToken(text)) return "";
+  return normaliseWhitespace(text);
 }
-
@@ -6,6 +6,10 @@
 std::string toUpperCase(const std::string& text);
 std::string toLowerCase(const std::string& text);
 std::string normaliseWhitespace(const std::string& text);
+// in-place forms of the above, for cells that are being rewritten anyway
+void toUpperCaseInPlace(std::string& text);
+void toLowerCaseInPlace(std::string& text);
+void normaliseWhitespaceInPlace(std::string& text);
 std::string normalisePunctuation(const std::string& text);
 std::string standardiseNullValues(const std::string& text);
 std::string removeStateSuffixes(const std::string& text);
@@ -0,0 +1,113 @@
+#include "utf8.h"
+#include "ascii_kernels.h"
+#include "char_class.h"
+#include "unicode_case_tables.h"
+#include <algorithm>
+#include <iterator>
+
+static const char32_t INVALID_BYTE_BASE = 0xDC00;
+
+static bool isContinuation(unsigned char c) { return (c & 0xC0) == 0x80; }
+
+char32_t nextCodePoint(std::string_view s, size_t& i) {
+  const unsigned char b0 = static_cast<unsigned char>(s[i]);
+  if (b0 < 0x80) { i++; return b0; }
+  const size_t left = s.size() - i;
+  auto at = [&](size_t k) { return static_cast<unsigned char>(s[i + k]); };
+  // second-byte ranges exclude overlong forms, surrogates and > U+10FFFF
+  if (b0 >= 0xC2 && b0 <= 0xDF && left >= 2 && isContinuation(at(1))) {
+    char32_t cp = (char32_t(b0 & 0x1F) << 6) | (at(1) & 0x3F);
+    i += 2;
+    return cp;
+  }
+  if (b0 >= 0xE0 && b0 <= 0xEF && left >= 3) {
+    unsigned char lo = b0 == 0xE0 ? 0xA0 : 0x80, hi = b0 == 0xED ? 0x9F : 0xBF;
+    if (at(1) >= lo && at(1) <= hi && isContinuation(at(2))) {
+      char32_t cp = (char32_t(b0 & 0x0F) << 12) | (char32_t(at(1) & 0x3F) << 6) | (at(2) & 0x3F);
+      i += 3;
+      return cp;
+    }
+  }
+  if (b0 >= 0xF0 && b0 <= 0xF4 && left >= 4) {
+    unsigned char lo = b0 == 0xF0 ? 0x90 : 0x80, hi = b0 == 0xF4 ? 0x8F : 0xBF;
+    if (at(1) >= lo && at(1) <= hi && isContinuation(at(2)) && isContinuation(at(3))) {
+      char32_t cp = (char32_t(b0 & 0x07) << 18) | (char32_t(at(1) & 0x3F) << 12) |
+                    (char32_t(at(2) & 0x3F) << 6) | (at(3) & 0x3F);
+      i += 4;
+      return cp;
+    }
+  }
+  i++;
+  return INVALID_BYTE_BASE + b0;
+}
+
+void decodeUtf8(std::string_view s, std::vector<char32_t>& out) {
+  out.clear();
+  out.reserve(s.size());
+  for (size_t i = 0; i < s.size();) out.push_back(nextCodePoint(s, i));
+}
+
+size_t codePointCount(std::string_view s) {
+  if (isAscii(s.data(), s.size())) return s.size();
+  size_t n = 0;
+  for (size_t i = 0; i < s.size(); n++) nextCodePoint(s, i);
+  return n;
+}
+
+void appendUtf8(char32_t cp, std::string& out) {
+  if (cp < 0x80) {
+    out += static_cast<char>(cp);
+  } else if (cp >= INVALID_BYTE_BASE + 0x80 && cp <= INVALID_BYTE_BASE + 0xFF) {
+    out += static_cast<char>(cp - INVALID_BYTE_BASE);
+  } else if (cp < 0x800) {
+    out += static_cast<char>(0xC0 | (cp >> 6));
+    out += static_cast<char>(0x80 | (cp & 0x3F));
+  } else if (cp < 0x10000) {
+    out += static_cast<char>(0xE0 | (cp >> 12));
+    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (cp & 0x3F));
+  } else {
+    out += static_cast<char>(0xF0 | (cp >> 18));
+    out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (cp & 0x3F));
+  }
+}
+
+// --- case mapping ----------------------------------------------------------
+
+// The runs of a table are sorted and disjoint: the candidate is the last run
+// starting at or before cp.
+template <size_t N>
+static char32_t mapCodePoint(const CaseRun (&runs)[N], char32_t cp) {
+  auto it = std::upper_bound(std::begin(runs), std::end(runs), cp,
+                             [](char32_t c, const CaseRun& r) { return c < r.first; });
+  if (it == std::begin(runs)) return cp;
+  const CaseRun& run = *(it - 1);
+  if (cp > run.last || (cp - run.first) % run.stride != 0) return cp;
+  return static_cast<char32_t>(static_cast<int32_t>(cp) + run.delta);
+}
+
+char32_t upperCodePoint(char32_t cp) {
+  return cp < 0x80 ? static_cast<unsigned char>(upperChar(static_cast<char>(cp))) : mapCodePoint(UPPER_RUNS, cp);
+}
+
+char32_t lowerCodePoint(char32_t cp) {
+  return cp < 0x80 ? static_cast<unsigned char>(lowerChar(static_cast<char>(cp))) : mapCodePoint(LOWER_RUNS, cp);
+}
+
+char32_t foldCodePoint(char32_t cp) {
+  return cp < 0x80 ? static_cast<unsigned char>(lowerChar(static_cast<char>(cp))) : mapCodePoint(FOLD_RUNS, cp);
+}
+
+template <typename Map>
+static std::string mapString(std::string_view s, Map map) {
+  std::string out;
+  out.reserve(s.size());
+  for (size_t i = 0; i < s.size();) appendUtf8(map(nextCodePoint(s, i)), out);
+  return out;
+}
+
+std::string utf8ToUpper(std::string_view s) { return mapString(s, upperCodePoint); }
+std::string utf8ToLower(std::string_view s) { return mapString(s, lowerCodePoint); }
+std::string utf8FoldCase(std::string_view s) { return mapString(s, foldCodePoint); }
@@ -0,0 +1,35 @@
+#ifndef UTF8_H
+#define UTF8_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// UTF-8 decoding and Unicode simple case mapping for the text functions that
+// must treat "é" as one character.  Case tables are generated runs
+// (unicode_case_tables.h, from backend/tools/gen_case_tables.py); mappings
+// are one code point to one code point, so "ß" keeps its case.
+//
+// Malformed input never fails: each byte that does not start a valid
+// sequence decodes to U+DC80..U+DCFF (a lone surrogate, which no valid text
+// contains) and encodes back to the same byte, so invalid cells round-trip
+// unchanged and still compare unequal to every real character.
+
+// Decodes the code point at s[i] and advances i past it.
+char32_t nextCodePoint(std::string_view s, size_t& i);
+void decodeUtf8(std::string_view s, std::vector<char32_t>& out);
+void appendUtf8(char32_t cp, std::string& out);
+size_t codePointCount(std::string_view s);
+
+char32_t upperCodePoint(char32_t cp);
+char32_t lowerCodePoint(char32_t cp);
+char32_t foldCodePoint(char32_t cp);  // case folding, for comparison keys
+
+// Whole-string mappings.  Callers check isAscii() first and keep ASCII cells
+// on the byte kernels; these handle any input.
+std::string utf8ToUpper(std::string_view s);
+std::string utf8ToLower(std::string_view s);
+std::string utf8FoldCase(std::string_view s);
+
+#endif
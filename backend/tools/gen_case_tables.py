@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+"""Generates backend/src/text/unicode_case_tables.h from Python's unicodedata.
+
+Each table is a sorted list of runs {first, last, delta, stride}: every code
+point first, first+stride, ..., last maps to itself + delta.  Alternating
+upper/lower pairs (Latin Extended, Cyrillic, ...) collapse into stride-2 runs,
+which keeps all three tables to a few hundred entries.
+
+Only one-to-one mappings are kept ("ß".upper() is "SS" and is left out),
+so every mapping is a single code point.
+
+    python3 backend/tools/gen_case_tables.py > backend/src/text/unicode_case_tables.h
+"""
+import sys
+import unicodedata
+
+
+def mappings(fn):
+    out = []
+    for cp in range(0x80, 0x110000):
+        if 0xD800 <= cp <= 0xDFFF:
+            continue
+        ch = chr(cp)
+        mapped = fn(ch)
+        if len(mapped) == 1 and mapped != ch:
+            out.append((cp, ord(mapped) - cp))
+    return out
+
+
+def runs(pairs):
+    out = []
+    for cp, delta in pairs:
+        if out:
+            first, last, d, stride = out[-1]
+            if d == delta and (first == last and cp - last in (1, 2) or cp - last == stride):
+                out[-1] = (first, cp, d, cp - last)
+                continue
+        out.append((cp, cp, delta, 1))
+    return out
+
+
+def emit(name, table):
+    print(f"static const CaseRun {name}[] = {{")
+    for first, last, delta, stride in table:
+        print(f"  {{0x{first:05X}, 0x{last:05X}, {delta}, {stride}}},")
+    print("};\n")
+
+
+def main():
+    tables = [
+        ("UPPER_RUNS", runs(mappings(str.upper))),
+        ("LOWER_RUNS", runs(mappings(str.lower))),
+        ("FOLD_RUNS", runs(mappings(str.casefold))),
+    ]
+    print("// Generated by backend/tools/gen_case_tables.py from Unicode "
+          f"{unicodedata.unidata_version}; do not edit.")
+    print("#ifndef UNICODE_CASE_TABLES_H\n#define UNICODE_CASE_TABLES_H\n")
+    print("#include <cstdint>\n")
+    print("struct CaseRun {\n  uint32_t first;\n  uint32_t last;\n  int32_t delta;\n  uint32_t stride;\n};\n")
+    for name, table in tables:
+        emit(name, table)
+    print("#endif")
+    for name, table in tables:
+        print(f"{name}: {len(table)} runs", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,107 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "blocking_keys.h"
+
+class BlockingKeysTest {
+public:
+  // letter plus three digits, as printed in the usual Soundex tables
+  std::string soundexString(const std::string& word) {
+    uint16_t code = soundexCode(word);
+    if (code == 0) return "";
+    std::string out(1, static_cast<char>('A' + (code >> 9) - 1));
+    for (int d = 0; d < 3; d++) out += static_cast<char>('0' + ((code >> (6 - 3 * d)) & 7));
+    return out;
+  }
+
+  void test_soundex_reference_codes() {
+    assert(soundexString("Robert") == "R163");
+    assert(soundexString("Rupert") == "R163");
+    assert(soundexString("Rubin") == "R150");
+    assert(soundexString("Ashcraft") == "A261");
+    assert(soundexString("Tymczak") == "T522");
+    assert(soundexString("Pfister") == "P236");
+    assert(soundexString("Honeyman") == "H555");
+    assert(soundexString("Lee") == "L000");
+    assert(soundexCode("1234") == 0);
+    std::cout << "PASS: Soundex reference codes\n";
+  }
+
+  void test_ascii_fold() {
+    assert(asciiFold("Jos\xC3\xA9 M\xC3\xBCller") == "jose muller");
+    assert(asciiFold("\xC3\x86SIR \xC3\x87\xC3\xA0") == "asir ca");
+    assert(asciiFold("plain ASCII") == "plain ascii");
+    std::cout << "PASS: ASCII folding of Latin-1 letters\n";
+  }
+
+  void test_prefix_order_and_email_local_part() {
+    assert(packPrefix("abc", 4) < packPrefix("abd", 4));
+    assert(packPrefix("ab", 4) < packPrefix("abc", 4));
+    assert(packPrefix("9z", 4) < packPrefix("a", 4));
+    assert(packPrefix("abcdef", 4) == packPrefix("abcdxx", 4));
+    assert(emailLocalPart("j.smith+news@example.com") == "j.smith");
+    assert(emailLocalPart("nobody") == "nobody");
+    std::cout << "PASS: packed prefixes sort like the text; email local parts\n";
+  }
+
+  void test_row_keys() {
+    std::vector<ColumnType> types = {ColumnType::ID, ColumnType::NAME, ColumnType::EMAIL,
+                                     ColumnType::NUMERIC};
+    uint64_t a = rowBlockingKey({"17", "Smith, John", "J.Smith+x@a.com", "3"}, types);
+    uint64_t b = rowBlockingKey({"99", "john smyth", "j.smith@b.org", "4"}, types);
+    uint64_t c = rowBlockingKey({"17", "Mary Jones", "mjones@a.com", "3"}, types);
+    assert(a == b);  // "john" is the first token in both; ID and NUMERIC ignored
+    assert(a != c);
+    // keys fill from the left, so the first keyed column dominates the order
+    std::vector<ColumnType> text = {ColumnType::GENERIC_TEXT, ColumnType::GENERIC_TEXT};
+    assert(rowBlockingKey({"apple", "zzz"}, text) < rowBlockingKey({"banana", "aaa"}, text));
+    std::cout << "PASS: row keys agree on near-duplicates\n";
+  }
+
+  void test_url_and_phone_keys() {
+    assert(urlHost("https://www.example.com:8080/a?b") == "example.com");
+    assert(urlHost("example.org/path") == "example.org");
+    assert(packTrailingDigits("+44 7700 900123", 8) == packTrailingDigits("07700-900123", 8));
+    assert(packTrailingDigits("ext", 8) == 0);
+
+    // a URL or PHONE column alone must still separate rows: the shared
+    // "http"/"+447" prefix is not what the key is built from
+    std::vector<ColumnType> url = {ColumnType::ID, ColumnType::URL};
+    std::vector<ColumnType> phone = {ColumnType::ID, ColumnType::PHONE};
+    assert(rowBlockingKey({"1", "https://www.acme.com/about"}, url) ==
+           rowBlockingKey({"2", "http://ACME.com/contact"}, url));
+    assert(rowBlockingKey({"1", "https://www.acme.com/"}, url) !=
+           rowBlockingKey({"2", "https://www.zenith.io/"}, url));
+    assert(rowBlockingKey({"1", "+44 7700 900123"}, phone) ==
+           rowBlockingKey({"2", "(07700) 900 123"}, phone));
+    assert(rowBlockingKey({"1", "+44 7700 900123"}, phone) !=
+           rowBlockingKey({"2", "+44 7700 900456"}, phone));
+    std::cout << "PASS: URL keys use the host, PHONE keys the trailing digits\n";
+  }
+
+  void test_row_without_keyed_columns() {
+    std::vector<ColumnType> numeric = {ColumnType::ID, ColumnType::NUMERIC, ColumnType::DATE};
+    assert(rowBlockingKey({"17", "3.5", "2024-01-02"}, numeric) == 0);
+    assert(rowBlockingKey({"18", "9", "1999-12-31"}, numeric) == 0);
+    assert(rowBlockingKey({}, {}) == 0);
+    std::cout << "PASS: rows with no keyed column share the zero key\n";
+  }
+
+  void run_all() {
+    test_soundex_reference_codes();
+    test_ascii_fold();
+    test_prefix_order_and_email_local_part();
+    test_row_keys();
+    test_url_and_phone_keys();
+    test_row_without_keyed_columns();
+    std::cout << "\nAll blocking key tests passed (6/6)\n";
+  }
+};
+
+int main() {
+  BlockingKeysTest tests;
+  tests.run_all();
+  return 0;
+}
@@ -0,0 +1,93 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "cardinality_sketch.h"
+#include "csv_parser.h"
+#include "row_hash.h"
+
+class CardinalitySketchTest {
+public:
+  bool within(double estimate, double exact, double tolerance) {
+    return std::fabs(estimate - exact) <= exact * tolerance;
+  }
+
+  void test_small_sets_are_near_exact() {
+    HyperLogLog hll;
+    for (int rep = 0; rep < 3; rep++)
+      for (int i = 0; i < 100; i++) hll.add(hashCell("value" + std::to_string(i)));
+    assert(std::fabs(hll.estimate() - 100) < 2);
+    assert(HyperLogLog().estimate() == 0);
+    std::cout << "PASS: small sets are near exact\n";
+  }
+
+  void test_large_set_within_error() {
+    HyperLogLog hll;
+    for (int i = 0; i < 200000; i++) hll.add(hashCell(std::to_string(i)));
+    assert(within(hll.estimate(), 200000, 0.05));
+    std::cout << "PASS: 200k distinct values within 5%\n";
+  }
+
+  void test_merge_is_union() {
+    HyperLogLog a, b;
+    for (int i = 0; i < 30000; i++) a.add(hashCell(std::to_string(i)));
+    for (int i = 20000; i < 50000; i++) b.add(hashCell(std::to_string(i)));
+    a.merge(b);
+    assert(within(a.estimate(), 50000, 0.05));
+    bool threw = false;
+    try { a.merge(HyperLogLog(10)); } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+    std::cout << "PASS: merge estimates the union\n";
+  }
+
+  void test_estimate_duplicates_over_csv() {
+    std::string csv = "id,group,flag\n";
+    for (int i = 0; i < 60000; i++) {
+      int k = i % 40000;
+      csv += std::to_string(k) + ",g" + std::to_string(k % 300) + "," + (k % 2 ? "y" : "n") + "\n";
+    }
+    CsvRecordReader reader{std::string_view(csv)};
+    auto est = estimateDuplicates(reader);
+    assert(est.rows == 60001);
+    // 40000 distinct data rows plus the header
+    assert(within(est.distinctRows, 40001, 0.05));
+    assert(within(est.duplicateRows, 20000, 0.15));
+    assert(est.columnNames == (std::vector<std::string>{"id", "group", "flag"}));
+    assert(within(est.columnCardinality[0], 40000, 0.1));
+    assert(within(est.columnCardinality[1], 300, 0.05));
+    assert(std::fabs(est.columnCardinality[2] - 2) < 0.5);
+    std::cout << "PASS: duplicate and per-column estimates over CSV\n";
+  }
+
+  void test_estimate_types_columns_over_whole_stream() {
+    // amounts are numeric for the first 300 rows only; typing from the
+    // first rows alone would call the column NUMERIC
+    std::string csv = "email,amount\n";
+    for (int i = 0; i < 600; i++)
+      csv += "user" + std::to_string(i) + "@example.com," +
+             (i < 300 ? std::to_string(i) : "code-" + std::to_string(i) + "!") + "\n";
+    CsvRecordReader reader{std::string_view(csv)};
+    auto est = estimateDuplicates(reader);
+    assert(est.columnTypes.size() == 2);
+    assert(est.columnTypes[0] == ColumnType::EMAIL);
+    assert(est.columnTypes[1] == ColumnType::GENERIC_TEXT);
+    std::cout << "PASS: column types sampled over the whole stream\n";
+  }
+
+  void run_all() {
+    test_small_sets_are_near_exact();
+    test_large_set_within_error();
+    test_merge_is_union();
+    test_estimate_duplicates_over_csv();
+    test_estimate_types_columns_over_whole_stream();
+    std::cout << "\nAll cardinality sketch tests passed (5/5)\n";
+  }
+};
+
+int main() {
+  CardinalitySketchTest tests;
+  tests.run_all();
+  return 0;
+}
@@ -117,6 +117,22 @@ public:
     std::cout << "PASS: empty column → GENERIC_TEXT\n";
   }
 
+  void test_header_hint_words_and_priority() {
+    auto data = makeData(
+      {"Hotel", "Customer_Email_Name", "UPDATED AT", "is_active",
+       "averyveryverylongprefix_note", "paid"},
+      {{"", "", "", "", "", ""}}
+    );
+    auto result = detectColumnTypes(data);
+    assert(result.types[0] == ColumnType::GENERIC_TEXT);  // "tel" is not a word here
+    assert(result.types[1] == ColumnType::EMAIL);         // EMAIL outranks NAME
+    assert(result.types[2] == ColumnType::DATE);
+    assert(result.types[3] == ColumnType::BOOLEAN);
+    assert(result.types[4] == ColumnType::FREE_TEXT);
+    assert(result.types[5] == ColumnType::GENERIC_TEXT);  // "id" is not a word here
+    std::cout << "PASS: header hints match whole words by priority\n";
+  }
+
   void test_multiple_columns() {
     auto data = makeData(
       {"email", "price", "name"},
@@ -137,6 +153,65 @@ public:
     std::cout << "PASS: multiple columns with mixed types\n";
   }
 
+  void test_numeric_strtod_forms() {
+    // exponent, hex and thousands-separated forms all parse as numbers;
+    // an out-of-range exponent does not
+    auto data = makeData(
+      {"field_a", "field_b"},
+      {{"1e5", "1e999"}, {"0x1A", "42"}, {"1,234,567", "7"}, {"-2.5E-3", "8"}}
+    );
+    auto result = detectColumnTypes(data);
+    assert(result.types[0] == ColumnType::NUMERIC);
+    assert(result.types[1] == ColumnType::GENERIC_TEXT);
+    std::cout << "PASS: numeric strtod forms\n";
+  }
+
+  void test_day_first_dates_and_plain_numbers_not_phone() {
+    auto data = makeData(
+      {"field_a", "field_b"},
+      {
+        {"15/01/2024", "1234567"},
+        {"31-12-2023", "7654321.5"},
+        {"01/06/2024", "12345678"}
+      }
+    );
+    auto result = detectColumnTypes(data);
+    assert(result.types[0] == ColumnType::DATE);
+    assert(result.types[1] == ColumnType::NUMERIC);
+    std::cout << "PASS: day-first dates, digit runs stay NUMERIC\n";
+  }
+
+  void test_full_column_sees_late_format_change() {
+    std::vector<std::vector<std::string>> data = {{"field_x"}};
+    for (int i = 0; i < 300; i++) data.push_back({std::to_string(i)});
+    for (int i = 0; i < 300; i++) data.push_back({"code-" + std::to_string(i) + "!"});
+    // the first 200 values are all numbers...
+    assert(detectColumnTypes(data).types[0] == ColumnType::NUMERIC);
+    // ...but half the column is not, which full-column typing (serial or
+    // split across threads) and the streaming reservoir both notice
+    assert(detectColumnTypesFull(data, 1).types[0] == ColumnType::GENERIC_TEXT);
+    assert(detectColumnTypesFull(data, 4).types[0] == ColumnType::GENERIC_TEXT);
+    ColumnTypeSampler sampler(data[0]);
+    for (size_t i = 1; i < data.size(); i++) sampler.addRow(data[i]);
+    assert(sampler.finish().types[0] == ColumnType::GENERIC_TEXT);
+    std::cout << "PASS: full-column and reservoir typing see late format change\n";
+  }
+
+  void test_full_column_matches_sample_on_small_input() {
+    auto data = makeData(
+      {"email", "price", "name"},
+      {
+        {"alice@example.com", "42", "Alice Smith"},
+        {"bob@domain.org", "", "Bob Jones"}
+      }
+    );
+    auto sampled = detectColumnTypes(data);
+    auto full = detectColumnTypesFull(data);
+    assert(sampled.types == full.types);
+    assert(full.names == sampled.names);
+    std::cout << "PASS: full-column typing matches sample on small input\n";
+  }
+
   void test_column_type_to_string() {
     assert(std::string(columnTypeToString(ColumnType::EMAIL)) == "EMAIL");
     assert(std::string(columnTypeToString(ColumnType::GENERIC_TEXT)) == "GENERIC_TEXT");
@@ -159,10 +234,15 @@ public:
     test_name_via_header_hint();
     test_generic_text_fallback();
     test_empty_column();
+    test_header_hint_words_and_priority();
     test_multiple_columns();
+    test_numeric_strtod_forms();
+    test_day_first_dates_and_plain_numbers_not_phone();
+    test_full_column_sees_late_format_change();
+    test_full_column_matches_sample_on_small_input();
     test_column_type_to_string();
     test_type_weight();
-    std::cout << "\nAll column type detection tests passed (12/12)\n";
+    std::cout << "\nAll column type detection tests passed (17/17)\n";
   }
 };
 
@@ -0,0 +1,180 @@
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "dedup_index.h"
+
+namespace fs = std::filesystem;
+
+using Table = std::vector<std::vector<std::string>>;
+
+class DedupIndexTest {
+public:
+  fs::path dir = fs::temp_directory_path() / ("dedup-index-test-" + std::to_string(getpid()));
+  std::vector<std::string> header = {"id", "name", "email", "phone"};
+  std::vector<ColumnType> types = {ColumnType::ID, ColumnType::NAME, ColumnType::EMAIL,
+                                   ColumnType::PHONE};
+
+  Table customers(int from, int to) {
+    Table t = {header};
+    for (int i = from; i < to; i++) {
+      std::string n = std::to_string(i);
+      t.push_back({"C" + n, "Customer " + n, "user" + n + "@example.com", "555-01" + n});
+    }
+    return t;
+  }
+
+  // one upload run: filter against the index, then add what was kept
+  IndexFilterResult upload(const std::string& name, const Table& data, double threshold = 0.92) {
+    DedupIndex index(name, data[0], types, dir.string());
+    auto result = index.filter(data, threshold);
+    index.add(result.data);
+    index.save();
+    return result;
+  }
+
+  void test_overlapping_uploads_keep_only_new_rows() {
+    auto day1 = upload("daily", customers(0, 100));
+    assert(day1.data.size() == 101 && day1.exactMatches == 0);
+
+    auto day2 = upload("daily", customers(60, 130));
+    assert(day2.exactMatches == 40);
+    assert(day2.data.size() == 31);
+    assert(day2.data[0] == header);
+    assert(day2.data[1][0] == "C100");
+
+    DedupIndex index("daily", header, types, dir.string());
+    assert(index.size() == 130);
+    std::cout << "PASS: overlapping uploads keep only the new rows\n";
+  }
+
+  void test_normalised_rows_match_fuzzily() {
+    upload("fuzzy", {header, {"7", "John Smith", "John@Example.com", "555-010-7788"}});
+    auto next = upload("fuzzy", {header,
+                                 {"7", "smith  john", "john@example.com", "555.010.7788"},
+                                 {"8", "smith  john", "john@example.com", "555.010.7788"}});
+    // same person with reformatted cells is dropped; a different ID vetoes
+    assert(next.fuzzyMatches == 1);
+    assert(next.data.size() == 2 && next.data[1][0] == "8");
+    std::cout << "PASS: reformatted rows match the index, ID disagreement vetoes\n";
+  }
+
+  void test_header_mismatch_and_bad_names() {
+    upload("schema", customers(0, 5));
+    bool threw = false;
+    try { DedupIndex other("schema", {"id", "name"}, types, dir.string()); }
+    catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+
+    assert(isValidIndexName("daily_export-2"));
+    assert(!isValidIndexName(""));
+    assert(!isValidIndexName("../etc"));
+    assert(!isValidIndexName(std::string(65, 'a')));
+    threw = false;
+    try { DedupIndex bad("a/b", header, types, dir.string()); }
+    catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+    std::cout << "PASS: header mismatch and invalid names rejected\n";
+  }
+
+  void test_tokens_name_indexes_by_sha256() {
+    // FIPS 180-4 test vectors, including the two-block padding case
+    assert(indexNameForToken("abc") ==
+           "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    assert(indexNameForToken("") ==
+           "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    assert(indexNameForToken("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq") ==
+           "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+    assert(indexNameForToken(std::string(64, 'a')) ==
+           "ffe054fe7ae0cb6dc65c3af9b61d5209f439851db43d0ba5997337df154668eb");
+
+    assert(isValidIndexToken(std::string(32, 'k')) && isValidIndexToken(std::string(128, '_')));
+    assert(!isValidIndexToken("daily"));
+    assert(!isValidIndexToken(std::string(31, 'k')) && !isValidIndexToken(std::string(129, 'k')));
+    assert(!isValidIndexToken(std::string(40, 'k') + "/"));
+    assert(isValidIndexName(indexNameForToken(std::string(40, 'k'))));
+    std::cout << "PASS: tokens map to SHA-256 index names\n";
+  }
+
+  void test_corrupt_file_rejected() {
+    upload("corrupt", customers(0, 20));
+    fs::path idx = dir / "corrupt.idx";
+    fs::resize_file(idx, fs::file_size(idx) - 5);
+    bool threw = false;
+    try { DedupIndex index("corrupt", header, types, dir.string()); }
+    catch (const std::runtime_error&) { threw = true; }
+    assert(threw);
+    std::cout << "PASS: truncated index file rejected\n";
+  }
+
+  void test_save_appends_new_rows_only() {
+    upload("append", customers(0, 50));
+    fs::path idx = dir / "append.idx";
+    const uintmax_t base = fs::file_size(idx);
+    const uintmax_t record = (3 + header.size()) * 8;
+
+    // an unfinished append from a crashed request is ignored and overwritten
+    { std::ofstream junk(idx, std::ios::binary | std::ios::app); junk << "partial"; }
+    {
+      DedupIndex index("append", header, types, dir.string());
+      assert(index.size() == 50);
+      index.add(customers(40, 60));
+      index.save();
+    }
+    assert(fs::file_size(idx) == base + 10 * record);
+
+    auto next = upload("append", customers(0, 70));
+    assert(next.exactMatches == 60 && next.data.size() == 11);
+    assert(fs::file_size(idx) == base + 20 * record);
+    DedupIndex index("append", header, types, dir.string());
+    assert(index.size() == 70);
+    std::cout << "PASS: save appends only the rows added since load\n";
+  }
+
+  void test_prune_removes_lock_files() {
+    upload("stale", customers(0, 5));
+    upload("stale_held", customers(0, 5));
+    const auto old = fs::file_time_type::clock::now() - std::chrono::hours(24 * 40);
+    for (const char* f : {"stale.idx", "stale.lock", "stale_held.idx", "stale_held.lock"})
+      fs::last_write_time(dir / f, old);
+    { std::ofstream orphan(dir / "orphan.lock"); }
+    fs::last_write_time(dir / "orphan.lock", old);
+
+    {
+      // holding an index's lock keeps pruning away from it
+      DedupIndex held("stale_held", header, types, dir.string());
+      upload("fresh", customers(0, 5));
+      assert(fs::exists(dir / "stale_held.idx") && fs::exists(dir / "stale_held.lock"));
+    }
+    assert(!fs::exists(dir / "stale.idx") && !fs::exists(dir / "stale.lock"));
+    assert(!fs::exists(dir / "orphan.lock"));
+    assert(fs::exists(dir / "fresh.idx") && fs::exists(dir / "fresh.lock"));
+    std::cout << "PASS: pruning removes old indexes with their lock files\n";
+  }
+
+  void run_all() {
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    test_overlapping_uploads_keep_only_new_rows();
+    test_normalised_rows_match_fuzzily();
+    test_header_mismatch_and_bad_names();
+    test_tokens_name_indexes_by_sha256();
+    test_corrupt_file_rejected();
+    test_save_appends_new_rows_only();
+    test_prune_removes_lock_files();
+    fs::remove_all(dir);
+    std::cout << "\nAll dedup index tests passed (7/7)\n";
+  }
+};
+
+int main() {
+  DedupIndexTest tests;
+  tests.run_all();
+  return 0;
+}
@@ -0,0 +1,97 @@
+#include <cassert>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "row_hash.h"
+#include "string_issue_detectors.h"
+#include "structural_cleaners.h"
+
+class ExactDedupTest {
+public:
+  void test_keeps_header_and_first_occurrence() {
+    std::vector<std::vector<std::string>> data = {
+      {"id", "name"}, {"1", "a"}, {"2", "b"}, {"1", "a"}, {"id", "name"}, {"2", "b"}
+    };
+    auto result = removeDuplicates(data);
+    // the header is not compared against, so a data row equal to it is kept
+    assert(result.size() == 4);
+    assert(result[0] == data[0]);
+    assert(result[1] == data[1]);
+    assert(result[2] == data[2]);
+    assert(result[3] == data[4]);
+    assert(findUniqueRows(data) == (std::vector<size_t>{0, 1, 2, 4}));
+    std::cout << "PASS: header and first occurrences kept in order\n";
+  }
+
+  void test_cell_boundaries_distinguish_rows() {
+    std::vector<std::vector<std::string>> data = {
+      {"a", "b"}, {"ab", "c"}, {"a", "bc"}, {"abc", ""}, {"", "abc"}, {"abc"}
+    };
+    assert(hashRow(data[1]) != hashRow(data[2]));
+    assert(hashRow(data[3]) != hashRow(data[5]));
+    assert(removeDuplicates(data).size() == data.size());
+    std::cout << "PASS: cell boundaries distinguish rows\n";
+  }
+
+  void test_long_cells_and_tails() {
+    // cells longer than one 8-byte word that differ only in the tail
+    std::string base(37, 'x');
+    std::vector<std::vector<std::string>> data = {{"h"}, {base + "1"}, {base + "2"}, {base + "1"}};
+    auto result = removeDuplicates(data);
+    assert(result.size() == 3);
+    assert(result[2][0] == base + "2");
+    std::cout << "PASS: long cells compared to the last byte\n";
+  }
+
+  void test_rvalue_overload_matches_copy() {
+    std::vector<std::vector<std::string>> data = {{"k"}};
+    for (int i = 0; i < 50000; i++) data.push_back({std::to_string(i % 777), "v"});
+    auto copied = removeDuplicates(data);
+    auto moved = removeDuplicates(std::move(data));
+    assert(copied.size() == 778);
+    assert(moved == copied);
+    std::cout << "PASS: in-place overload matches copying overload\n";
+  }
+
+  void test_empty_and_header_only() {
+    assert(removeDuplicates(std::vector<std::vector<std::string>>{}).empty());
+    std::vector<std::vector<std::string>> header = {{"a", "b"}};
+    assert(removeDuplicates(header) == header);
+    std::cout << "PASS: empty input and header-only input\n";
+  }
+
+  void test_detect_duplicates_matches_ordered_set() {
+    std::vector<std::vector<std::string>> data = {{"a", "b"}};
+    for (int i = 0; i < 30000; i++)
+      data.push_back({std::to_string(i % 1237), i % 5 ? "x" : "y"});
+    data.push_back({"a", "b"});  // repeats the header
+    std::vector<bool> expected(data.size(), false);
+    std::set<std::vector<std::string>> seen;
+    for (size_t i = 0; i < data.size(); i++)
+      if (!seen.insert(data[i]).second) expected[i] = true;
+    assert(detectDuplicates(data, 1) == expected);
+    assert(detectDuplicates(data, 3) == expected);
+    assert(detectDuplicates(data, 8) == expected);
+    assert(expected.back());
+    assert(detectDuplicates({}, 4).empty());
+    std::cout << "PASS: partitioned detectDuplicates matches serial flags\n";
+  }
+
+  void run_all() {
+    test_keeps_header_and_first_occurrence();
+    test_cell_boundaries_distinguish_rows();
+    test_long_cells_and_tails();
+    test_rvalue_overload_matches_copy();
+    test_empty_and_header_only();
+    test_detect_duplicates_matches_ordered_set();
+    std::cout << "\nAll exact dedup tests passed (6/6)\n";
+  }
+};
+
+int main() {
+  ExactDedupTest tests;
+  tests.run_all();
+  return 0;
+}
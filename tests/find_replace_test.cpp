@@ -0,0 +1,141 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "find_replace_rules.h"
+
+class FindReplaceTest {
+public:
+  FindReplaceRule exact(const std::string& find, const std::string& replace,
+                        bool caseSensitive = false) {
+    return {find, replace, "exact", caseSensitive};
+  }
+
+  std::vector<std::vector<std::string>> makeData(
+      const std::vector<std::string>& headers,
+      const std::vector<std::vector<std::string>>& rows) {
+    std::vector<std::vector<std::string>> data;
+    data.push_back(headers);
+    for (const auto& row : rows) data.push_back(row);
+    return data;
+  }
+
+  void test_exact_case_insensitive() {
+    auto data = makeData({"country"}, {{"uk"}, {"U.K."}, {"France"}, {"UK"}});
+    std::vector<FindReplaceRule> rules = {exact("uk", "United Kingdom"),
+                                          exact("u.k.", "United Kingdom")};
+    auto result = applyFindReplace(data, "country", rules, data[0]);
+    assert(result.data[1][0] == "United Kingdom");
+    assert(result.data[2][0] == "United Kingdom");
+    assert(result.data[3][0] == "France");
+    assert(result.data[4][0] == "United Kingdom");
+    assert(result.totalReplacements == 3);
+    assert(result.replacementCounts["country"] == 3);
+    std::cout << "PASS: exact case-insensitive rules\n";
+  }
+
+  void test_exact_case_sensitive() {
+    auto data = makeData({"code"}, {{"ab"}, {"AB"}});
+    std::vector<FindReplaceRule> rules = {exact("AB", "X", true)};
+    auto result = applyFindReplace(data, "code", rules, data[0]);
+    assert(result.data[1][0] == "ab");
+    assert(result.data[2][0] == "X");
+    assert(result.totalReplacements == 1);
+    std::cout << "PASS: exact case-sensitive rule\n";
+  }
+
+  void test_exact_rules_chain_in_order() {
+    // A->B then B->C must still resolve to C; C->A listed before is not
+    // re-applied because rules only run once each, in list order
+    auto data = makeData({"v"}, {{"A"}, {"C"}});
+    std::vector<FindReplaceRule> rules = {exact("C", "A", true), exact("A", "B", true),
+                                          exact("B", "C", true)};
+    auto result = applyFindReplace(data, "v", rules, data[0]);
+    assert(result.data[1][0] == "C");
+    assert(result.data[2][0] == "C");  // C->A->B->C: changed and back again
+    assert(result.totalReplacements == 1);
+    std::cout << "PASS: exact rules chain in list order\n";
+  }
+
+  void test_duplicate_find_first_rule_wins() {
+    auto data = makeData({"v"}, {{"x"}});
+    std::vector<FindReplaceRule> rules = {exact("x", "first"), exact("X", "second")};
+    auto result = applyFindReplace(data, "v", rules, data[0]);
+    assert(result.data[1][0] == "first");
+    std::cout << "PASS: first of duplicate exact rules wins\n";
+  }
+
+  void test_exact_mixed_with_substring() {
+    // substring rule between two exact runs splits the index
+    auto data = makeData({"v"}, {{"red"}});
+    std::vector<FindReplaceRule> rules = {exact("red", "dark red"),
+                                          {"dark", "light", "substring", false},
+                                          exact("light red", "pink")};
+    auto result = applyFindReplace(data, "v", rules, data[0]);
+    assert(result.data[1][0] == "pink");
+    std::cout << "PASS: exact rules around a substring rule\n";
+  }
+
+  void test_wildcard_column_counts() {
+    auto data = makeData({"a", "b"}, {{"n/a", "ok"}, {"N/A", "n/a"}});
+    std::vector<FindReplaceRule> rules = {exact("n/a", "")};
+    auto result = applyFindReplace(data, "*", rules, data[0]);
+    assert(result.totalReplacements == 3);
+    assert(result.replacementCounts["a"] == 2);
+    assert(result.replacementCounts["b"] == 1);
+    assert(result.data[1][1] == "ok");
+    std::cout << "PASS: wildcard column per-header counts\n";
+  }
+
+  void test_many_exact_rules() {
+    std::vector<FindReplaceRule> rules;
+    for (int i = 0; i < 5000; i++)
+      rules.push_back(exact("key" + std::to_string(i), "val" + std::to_string(i)));
+    auto data = makeData({"v"}, {{"KEY4999"}, {"key17"}, {"other"}});
+    auto result = applyFindReplace(data, "v", rules, data[0]);
+    assert(result.data[1][0] == "val4999");
+    assert(result.data[2][0] == "val17");
+    assert(result.data[3][0] == "other");
+    assert(result.totalReplacements == 2);
+    std::cout << "PASS: thousands of exact rules\n";
+  }
+
+  void test_parallel_matches_serial() {
+    std::vector<std::vector<std::string>> data = {{"a", "b", "c"}};
+    for (int i = 0; i < 20000; i++) {
+      data.push_back({"n/a", "row " + std::to_string(i % 7), i % 3 ? "x" : "N/A"});
+    }
+    std::vector<FindReplaceRule> rules = {exact("n/a", "missing"),
+                                          {"row 3", "ROW-3", "substring", true}};
+    auto serial = applyFindReplace(data, "*", rules, data[0]);
+    auto parallel = applyFindReplaceParallel(data, "*", rules, data[0], 4);
+    assert(parallel.data == serial.data);
+    assert(parallel.totalReplacements == serial.totalReplacements);
+    assert(parallel.replacementCounts == serial.replacementCounts);
+    assert(parallel.replacementCounts["a"] == 20000);
+
+    auto single = applyFindReplaceParallel(data, "c", rules, data[0], 3);
+    assert(single.replacementCounts["c"] == serial.replacementCounts["c"]);
+    assert(single.data[1][0] == "n/a");
+    std::cout << "PASS: parallel mode matches serial results and counts\n";
+  }
+
+  void run_all() {
+    test_exact_case_insensitive();
+    test_exact_case_sensitive();
+    test_exact_rules_chain_in_order();
+    test_duplicate_find_first_rule_wins();
+    test_exact_mixed_with_substring();
+    test_wildcard_column_counts();
+    test_many_exact_rules();
+    test_parallel_matches_serial();
+    std::cout << "\nAll find/replace tests passed (8/8)\n";
+  }
+};
+
+int main() {
+  FindReplaceTest tests;
+  tests.run_all();
+  return 0;
+}
@@ -0,0 +1,83 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "structural_cleaners.h"
+
+class FuzzyDedupTest {
+public:
+  // pseudo-random lower-case word, so unrelated rows are far apart
+  std::string word(unsigned& seed, int len) {
+    std::string w;
+    for (int k = 0; k < len; k++) {
+      seed = seed * 1103515245u + 12345u;
+      w += static_cast<char>('a' + (seed >> 16) % 26);
+    }
+    return w;
+  }
+
+  std::vector<std::vector<std::string>> makeCustomers(int n) {
+    std::vector<std::vector<std::string>> data = {{"name", "city", "email"}};
+    unsigned seed = 42;
+    for (int i = 0; i < n; i++) {
+      std::string name = word(seed, 6) + " " + word(seed, 8);
+      std::string city = word(seed, 7);
+      std::string email = word(seed, 5) + "@example.com";
+      data.push_back({name, city, email});
+      if (i % 4 == 0) data.push_back({name.substr(0, 1) + "X" + name.substr(2), city, email});
+      if (i % 9 == 0) data.push_back({name, city + "s", email});
+    }
+    return data;
+  }
+
+  void test_blocked_matches_exhaustive() {
+    auto data = makeCustomers(400);
+    auto exhaustive = fuzzyDeduplicateRows(data, 0.9, FuzzyDedupMode::EXHAUSTIVE);
+    auto blocked = fuzzyDeduplicateRows(data, 0.9, FuzzyDedupMode::BLOCKED, 1);
+    auto parallel = fuzzyDeduplicateRows(data, 0.9, FuzzyDedupMode::BLOCKED, 4);
+    assert(blocked == exhaustive);
+    assert(parallel == blocked);
+    assert(blocked.size() == 401);  // header + one row per customer
+    std::cout << "PASS: blocked mode matches exhaustive on near-duplicates\n";
+  }
+
+  void test_leading_column_edit_caught_by_reverse_pass() {
+    // the first cell differs at its first byte, which sorts the pair far
+    // apart in column order; the reverse-order pass brings them together
+    std::vector<std::vector<std::string>> data = {{"code", "description", "owner"}};
+    unsigned seed = 7;
+    for (int i = 0; i < 200; i++)
+      data.push_back({"m" + word(seed, 6), word(seed, 12), word(seed, 8)});
+    data.push_back({"a-widget", "long shared description text", "alice smith"});
+    data.push_back({"z-widget", "long shared description text", "alice smith"});
+    auto exhaustive = fuzzyDeduplicateRows(data, 0.9, FuzzyDedupMode::EXHAUSTIVE);
+    auto blocked = fuzzyDeduplicateRows(data, 0.9);
+    assert(blocked == exhaustive);
+    assert(blocked.size() == data.size() - 1);
+    assert(blocked.back()[0] == "a-widget");
+    std::cout << "PASS: reverse-order pass catches leading-column edits\n";
+  }
+
+  void test_header_and_tiny_inputs() {
+    std::vector<std::vector<std::string>> data = {{"a", "b"}, {"a", "b"}, {"a", "b"}};
+    assert(fuzzyDeduplicateRows(data, 0.9).size() == 2);  // header kept
+    std::vector<std::vector<std::string>> one = {{"a"}};
+    assert(fuzzyDeduplicateRows(one, 0.9) == one);
+    assert(fuzzyDeduplicateRows({}, 0.9).empty());
+    std::cout << "PASS: header kept and tiny inputs unchanged\n";
+  }
+
+  void run_all() {
+    test_blocked_matches_exhaustive();
+    test_leading_column_edit_caught_by_reverse_pass();
+    test_header_and_tiny_inputs();
+    std::cout << "\nAll fuzzy dedup tests passed (3/3)\n";
+  }
+};
+
+int main() {
+  FuzzyDedupTest tests;
+  tests.run_all();
+  return 0;
+}
@@ -0,0 +1,95 @@
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "imputation.h"
+
+class ImputationTest {
+public:
+  using Table = std::vector<std::vector<std::string>>;
+
+  // Age numeric with two gaps, Embarked categorical with one, Survived 0/1
+  Table train() {
+    Table t = {{"Name", "Age", "Embarked", "Survived", "Score"}};
+    const char* ages[] = {"22.0", "38.0", "", "26.0", "35.0", "35.0", "54.0", "2.0", "", "27.5", "14.0", "4.0"};
+    const char* ports[] = {"s", "c", "s", "q", "", "c", "s", "q", "c", "s", "q", "c"};
+    const char* scores[] = {"0.1", "0.2", "0.4", "", "", "", "", "", "", "", "", ""};
+    for (int i = 0; i < 12; i++)
+      t.push_back({"p" + std::to_string(i), ages[i], ports[i], i % 3 ? "0" : "1", scores[i]});
+    return t;
+  }
+
+  void test_format_float() {
+    assert(formatFloat(28.0) == "28.0");
+    assert(formatFloat(29.433767258382645) == "29.433767258382645");
+    assert(formatFloat(0.1) == "0.1");
+    assert(formatFloat(-2.5) == "-2.5");
+    assert(formatFloat(0.0001) == "0.0001");
+    assert(formatFloat(1.5e-5) == "1.5e-05");
+    assert(formatFloat(1e16) == "1e+16");
+    assert(formatFloat(123456789012345.6) == "123456789012345.6");
+    std::cout << "PASS: floats format like Python's repr\n";
+  }
+
+  void test_strategies() {
+    ImputeOptions options;
+    auto mean = imputeMissingValues(train(), options);
+    // python: sum(ages) / 10, statistics.median(ages)
+    assert(mean.data[3][1] == "25.75" && mean.data[9][1] == "25.75");
+    assert(mean.data[5][2] == "c");  // c 4, s 4: tie goes to the smaller
+    assert(mean.data[4][4] == "0.23333333333333336");
+    assert(mean.data[4][3] == "1" && mean.data[1][0] == "p0");
+    assert(mean.cellsFilled == 2 + 1 + 9);
+    assert(mean.columns.size() == 3 && mean.columns[0].name == "Age" && mean.columns[0].numeric);
+
+    options.numeric = NumericImpute::MEDIAN;
+    options.categorical = CategoricalImpute::DUMMY;
+    auto median = imputeMissingValues(train(), options);
+    assert(median.data[3][1] == "26.75" && median.data[5][2] == "missing");
+
+    options.numeric = NumericImpute::MODE;
+    options.columns = {"Age"};
+    auto mode = imputeMissingValues(train(), options);
+    assert(mode.data[3][1] == "35.0" && mode.data[5][2].empty());
+    assert(mode.cellsFilled == 2);
+
+    options.columns = {"Fare"};
+    bool threw = false;
+    try { imputeMissingValues(train(), options); } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+    std::cout << "PASS: mean, median, mode and dummy strategies\n";
+  }
+
+  void test_fit_on_train_apply_to_test() {
+    ImputeOptions options;
+    options.threadCount = 3;
+    auto fills = fitImputation(train(), options);
+    // Survived has no gaps in train but is still fitted; 0/1 is numeric,
+    // as in pandas
+    bool sawSurvived = false;
+    for (const auto& f : fills)
+      if (f.name == "Survived") { sawSurvived = true; assert(f.numeric && f.fillValue == "0.3333333333333333"); }
+    assert(sawSurvived);
+
+    Table test = {{"Survived", "Age", "Embarked"}, {"", "", "q"}, {"1", "40.0", ""}};
+    auto applied = applyImputation(test, fills);
+    assert(applied.data[1][0] == "0.3333333333333333" && applied.data[1][1] == "25.75" && applied.data[2][2] == "c");
+    assert(applied.cellsFilled == 3 && applied.columns.size() == 3);
+    std::cout << "PASS: statistics fitted on one table fill another\n";
+  }
+
+  void run_all() {
+    test_format_float();
+    test_strategies();
+    test_fit_on_train_apply_to_test();
+    std::cout << "\nAll imputation tests passed (3/3)\n";
+  }
+};
+
+int main() {
+  ImputationTest tests;
+  tests.run_all();
+  return 0;
+}
@@ -0,0 +1,74 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "csv_parser.h"
+#include "missing_values.h"
+#include "structural_cleaners.h"
+
+class MissingValuesTest {
+public:
+  using Table = std::vector<std::vector<std::string>>;
+
+  void test_counts() {
+    Table t = {{"a", "", "c"},  // an empty header cell is not a missing value
+               {"1", "", "3"},
+               {"", "", ""},
+               {"4", "5"},      // short row: c is missing
+               {"6", "7", "8", "extra"}};
+    MissingValueMap m = detectMissingValues(t);
+    assert(m.rows() == 5 && m.columns() == 3);
+    assert(m.columnCount(0) == 1 && m.columnCount(1) == 2 && m.columnCount(2) == 2);
+    assert(m.total() == 5);
+    assert(m.rowCounts() == std::vector<uint32_t>({0, 1, 3, 1, 0}));
+    assert(m.missing(3, 2) && !m.missing(0, 1));
+    std::cout << "PASS: per-column and per-row counts\n";
+  }
+
+  void test_large_and_streamed() {
+    // more than one 64-row word per column, filled while streaming records
+    std::string csv = "x,y\n";
+    size_t expectX = 0, expectY = 0;
+    for (int i = 0; i < 1000; i++) {
+      bool mx = i % 7 == 0, my = i % 64 == 63;
+      expectX += mx;
+      expectY += my;
+      csv += (mx ? "" : std::to_string(i)) + "," + (my ? "" : "\"v,\"\"" + std::to_string(i) + "\"") + "\n";
+    }
+    CsvRecordReader reader{std::string_view(csv)};
+    std::vector<std::string> row;
+    reader.next(row);
+    MissingValueMap streamed(row.size());
+    streamed.addRow(row);
+    while (reader.next(row)) streamed.addRow(row);
+    MissingValueMap parsed = detectMissingValues(parseCSV(csv));
+    assert(streamed.rows() == 1001 && streamed.columnCount(0) == expectX && streamed.columnCount(1) == expectY);
+    assert(streamed.column(0).words() == parsed.column(0).words());
+    assert(streamed.column(1).words() == parsed.column(1).words());
+    std::cout << "PASS: streamed map matches the parsed table\n";
+  }
+
+  void test_null_standardisation_fills_map() {
+    Table t = {{"name", "age"}, {"Ann", "N/A"}, {" null ", "31"}, {"Bob", "-"}, {"Cy", " 40 "}};
+    MissingValueMap m;
+    auto cleaned = standardiseNullValuesInData(t, &m);
+    assert(cleaned[1][1].empty() && cleaned[2][0].empty() && cleaned[4][1] == "40");
+    assert(m.columnCount(0) == 1 && m.columnCount(1) == 2);
+    assert(m.column(1).words() == detectMissingValues(cleaned).column(1).words());
+    std::cout << "PASS: null standardisation builds the map in the same pass\n";
+  }
+
+  void run_all() {
+    test_counts();
+    test_large_and_streamed();
+    test_null_standardisation_fills_map();
+    std::cout << "\nAll missing value tests passed (3/3)\n";
+  }
+};
+
+int main() {
+  MissingValuesTest tests;
+  tests.run_all();
+  return 0;
+}
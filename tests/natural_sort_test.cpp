@@ -0,0 +1,73 @@
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "structural_cleaners.h"
+
+class NaturalSortTest {
+public:
+  using Table = std::vector<std::vector<std::string>>;
+
+  std::vector<std::string> column(const Table& t, size_t c) {
+    std::vector<std::string> out;
+    for (const auto& row : t) out.push_back(c < row.size() ? row[c] : "<none>");
+    return out;
+  }
+
+  void test_order_and_header() {
+    Table t = {{"id", "file"},
+               {"1", "file10.txt"},
+               {"2", "file2.txt"},
+               {"3", "file1.txt"},
+               {"4", "file100000000000000000000.txt"},
+               {"5", "file99999999999999999999.txt"},
+               {"6", "File3.txt"},
+               {"7", "file02.txt"},
+               {"8"}};
+    auto sorted = naturalSort(t, 1);
+    assert(column(sorted, 0) == std::vector<std::string>({"id", "8", "6", "3", "2", "7", "1", "5", "4"}));
+    // out-of-range column: unchanged
+    assert(naturalSort(t, 5) == t && naturalSort(t, -1) == t);
+    // digit runs against other characters order like their first digit
+    assert(naturalSortKey("a/") < naturalSortKey("a1") && naturalSortKey("a9") < naturalSortKey("a:"));
+    assert(naturalSortKey("v0") < naturalSortKey("v00a") && naturalSortKey("x1.5") < naturalSortKey("x1.10"));
+    std::cout << "PASS: natural order with big numbers, header kept first\n";
+  }
+
+  void test_parallel_matches_serial() {
+    Table t = {{"key"}};
+    unsigned seed = 11;
+    for (int i = 0; i < 150000; i++) {
+      seed = seed * 1103515245u + 12345u;
+      unsigned r = seed >> 8;
+      t.push_back({"row" + std::to_string(r % 5000) + "-" + std::to_string(r % 7)});
+    }
+    auto serial = naturalSortOrder(t, 0, 1);
+    auto parallel = naturalSortOrder(t, 0, 5);
+    assert(serial == parallel && serial.size() == t.size() - 1);
+    // stable: equal keys keep their input order
+    for (size_t i = 1; i < serial.size(); i++) {
+      const std::string& a = t[serial[i - 1]][0];
+      const std::string& b = t[serial[i]][0];
+      assert(naturalSortKey(a) <= naturalSortKey(b));
+      if (a == b) assert(serial[i - 1] < serial[i]);
+    }
+    auto moved = naturalSort(Table(t), 0, 5);
+    assert(moved[0][0] == "key" && moved[1][0] == t[serial[0]][0] && moved.back()[0] == t[serial.back()][0]);
+    std::cout << "PASS: parallel permutation sort matches the serial one\n";
+  }
+
+  void run_all() {
+    test_order_and_header();
+    test_parallel_matches_serial();
+    std::cout << "\nAll natural sort tests passed (2/2)\n";
+  }
+};
+
+int main() {
+  NaturalSortTest tests;
+  tests.run_all();
+  return 0;
+}
@@ -7,6 +7,8 @@ std::string normaliseWhitespace(const std::string& text);
 std::string standardiseNullValues(const std::string& text);
 std::string toUpperCase(const std::string& text);
 std::string toLowerCase(const std::string& text);
+void toUpperCaseInPlace(std::string& text);
+void normaliseWhitespaceInPlace(std::string& text);
 
 class NormaliseWhitespaceRegressionTest {
 public:
@@ -59,6 +61,65 @@ public:
     std::cout << "PASS: all whitespace becomes empty\n";
   }
 
+  // Byte-at-a-time versions the vector kernels must agree with.
+  static std::string referenceCollapse(const std::string& text) {
+    std::string result;
+    bool inSpace = false;
+    for (char c : text) {
+      if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+        if (!inSpace && !result.empty()) { result += ' '; inSpace = true; }
+      } else {
+        result += c;
+        inSpace = false;
+      }
+    }
+    while (!result.empty() && result.back() == ' ') result.pop_back();
+    return result;
+  }
+
+  static std::string referenceUpper(std::string text) {
+    for (char& c : text) if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 32);
+    return text;
+  }
+
+  void test_long_cells_match_reference() {
+    // runs straddling 16- and 32-byte block edges, leading/trailing runs,
+    // and caseless non-ASCII (NBSP, and its bytes out of order as invalid
+    // UTF-8) that must pass through untouched
+    const char alphabet[] = {'a', 'Z', ' ', ' ', '\t', '\r', '\n', 'q', '\xC2', '\xA0', '{', '@', '`'};
+    unsigned seed = 12345;
+    for (int n = 0; n < 400; n++) {
+      std::string text;
+      for (int i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        text += alphabet[(seed >> 16) % sizeof(alphabet)];
+      }
+      assert(normaliseWhitespace(text) == referenceCollapse(text));
+      assert(toUpperCase(text) == referenceUpper(text));
+      std::string inPlace = text;
+      normaliseWhitespaceInPlace(inPlace);
+      assert(inPlace == referenceCollapse(text));
+      inPlace = text;
+      toUpperCaseInPlace(inPlace);
+      assert(inPlace == referenceUpper(text));
+    }
+    std::string padded = std::string(40, ' ') + "Hello" + std::string(37, '\t') + "World" + std::string(50, '\n');
+    assert(normaliseWhitespace(padded) == "Hello World");
+    std::cout << "PASS: long cells match the byte-at-a-time reference\n";
+  }
+
+  void test_case_mapping_keeps_non_ascii() {
+    assert(toUpperCase("[x]{y}@`") == "[X]{Y}@`");
+    assert(toLowerCase("ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_@") == "abcdefghijklmnopqrstuvwxyz[\\]^_@");
+    // one-to-one mappings apply to non-ASCII letters; one-to-many ones (ß ->
+    // SS) are left out, so ß keeps its case and its bytes
+    assert(toUpperCase("caf\xC3\xA9") == "CAF\xC3\x89");
+    assert(toLowerCase("CAF\xC3\x89") == "caf\xC3\xA9");
+    assert(toUpperCase("stra\xC3\x9F" "e") == "STRA\xC3\x9F" "E");
+    assert(toUpperCase("\xC2\xA0x\xE2\x82\xAC") == "\xC2\xA0X\xE2\x82\xAC");  // NBSP, euro: caseless
+    std::cout << "PASS: case mapping leaves non-letters alone, maps é, keeps ß\n";
+  }
+
   // --- standardiseNullValues tests ---
 
   void test_na_upper() {
@@ -167,6 +228,8 @@ public:
     test_mixed_whitespace_runs();
     test_empty_becomes_empty();
     test_all_whitespace_becomes_empty();
+    test_long_cells_match_reference();
+    test_case_mapping_keeps_non_ascii();
     test_na_upper();
     test_na_lower();
     test_na_no_slash();
@@ -183,7 +246,7 @@ public:
     test_non_null_preserved();
     test_non_null_case_preserved();
     test_null_with_whitespace();
-    std::cout << "\nAll normaliseWhitespace regression tests passed (24/24)\n";
+    std::cout << "\nAll normaliseWhitespace regression tests passed (26/26)\n";
   }
 };
 
@@ -0,0 +1,78 @@
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "null_tokens.h"
+#include "perfect_hash.h"
+#include "text_normalisation.h"
+
+class NullTokensTest {
+public:
+  void test_builtin_tokens() {
+    for (const char* cell : {"N/A", "n/a", "  Null\t", "none", "NiL", "missing", "NaN", "undefined",
+                             "-", " -- ", "?", "~", "", "   ", "\r\n"})
+      assert(isNullToken(cell));
+    for (const char* cell : {"N/A/", "NAB", "N A", "0", "nul", "---", "Nullable", "hello world"})
+      assert(!isNullToken(cell));
+    // long cells are rejected after the first few bytes
+    assert(!isNullToken(std::string(100000, 'N')));
+    assert(!isNullToken("NULL" + std::string(64, ' ') + "x"));
+    assert(isNullToken("NULL" + std::string(10000, ' ')));
+    assert(standardiseNullValues("  Hello   World ") == "Hello World");
+    std::cout << "PASS: built-in tokens match case- and blank-insensitively\n";
+  }
+
+  void test_custom_tokens() {
+    assert(setCustomNullTokens({"unknown", "#N/A", "not  available", " -999 ", ""}));
+    assert(isNullToken("UNKNOWN") && isNullToken("#n/a") && isNullToken("-999"));
+    assert(isNullToken("Not available") && isNullToken("  not \t AVAILABLE  "));
+    assert(isNullToken("N/A") && isNullToken("null"));  // built-ins stay
+    assert(!isNullToken("unknowns") && !isNullToken("-9999") && !isNullToken("not"));
+
+    std::string error;
+    assert(!setCustomNullTokens({std::string(65, 'x')}, &error));
+    assert(error.find("longer than 64") != std::string::npos);
+    assert(isNullToken("unknown"));  // a rejected list keeps the current tokens
+
+    std::vector<std::string> many;
+    for (int i = 0; i < 300; i++) many.push_back("token" + std::to_string(i));
+    assert(!setCustomNullTokens(many, &error));
+    assert(error.find("too many") != std::string::npos);
+
+    setenv("TOOLKIT_NULL_TOKENS", "unknown,,#REF!, tbd ", 1);
+    auto tokens = nullTokensFromEnvironment();
+    assert((tokens == std::vector<std::string>{"unknown", "#REF!", " tbd "}));
+    assert(setCustomNullTokens(tokens));
+    assert(isNullToken("TBD") && isNullToken("#ref!") && !isNullToken("-999"));
+    unsetenv("TOOLKIT_NULL_TOKENS");
+    assert(nullTokensFromEnvironment().empty());
+    std::cout << "PASS: custom tokens join the built-in ones\n";
+  }
+
+  void test_keyword_set() {
+    std::vector<std::string> keys;
+    for (int i = 0; i < 254; i++) keys.push_back("key-" + std::to_string(i * 7919));
+    keys.push_back("key-0");  // duplicate
+    KeywordSet set(keys);
+    assert(set.size() == 254);
+    for (int i = 0; i < 254; i++) assert(set.contains("key-" + std::to_string(i * 7919)));
+    for (int i = 1; i < 1000; i++) assert(!set.contains("key-" + std::to_string(i * 7919 + 1)));
+    assert(!KeywordSet().contains("") && !KeywordSet().contains("x"));
+    std::cout << "PASS: run-time keyword set finds every key and nothing else\n";
+  }
+
+  void run_all() {
+    test_builtin_tokens();
+    test_custom_tokens();
+    test_keyword_set();
+    std::cout << "\nAll null token tests passed (3/3)\n";
+  }
+};
+
+int main() {
+  NullTokensTest tests;
+  tests.run_all();
+  return 0;
+}
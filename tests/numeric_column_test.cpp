@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "numeric_column.h"
+#include "string_issue_detectors.h"
+
+class NumericColumnTest {
+public:
+  using Table = std::vector<std::vector<std::string>>;
+
+  static bool close(double a, double b) { return std::fabs(a - b) <= 1e-9 * std::max(1.0, std::fabs(b)); }
+
+  // column "v" of n numeric cells (every fifth row is non-numeric)
+  Table table(size_t n, unsigned seed) {
+    Table t = {{"id", "v"}};
+    for (size_t i = 0, added = 0; added < n; i++) {
+      if (i % 5 == 3) { t.push_back({std::to_string(i), i % 2 ? "" : "n/a"}); continue; }
+      seed = seed * 1103515245u + 12345u;
+      t.push_back({std::to_string(i), std::to_string(static_cast<int>(seed >> 16) % 2001 - 1000) + ".5"});
+      added++;
+    }
+    return t;
+  }
+
+  static double median(std::vector<double> v) {
+    std::sort(v.begin(), v.end());
+    size_t n = v.size();
+    return n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2.0;
+  }
+
+  void test_stats_match_scalar_reference() {
+    for (size_t n : {1u, 2u, 7u, 10u, 1003u}) {
+      Table t = table(n, static_cast<unsigned>(n));
+      NumericColumn column(t, 1);
+      std::vector<double> v;
+      for (size_t r = 1; r < t.size(); r++)
+        if (column.valid(r)) v.push_back(std::stod(t[r][1]));
+      assert(column.count() == n && v.size() == n && !column.valid(0));
+
+      double mean = 0, ss = 0;
+      for (double x : v) mean += x;
+      mean /= n;
+      for (double x : v) ss += (x - mean) * (x - mean);
+      std::vector<double> dev;
+      for (double x : v) dev.push_back(std::fabs(x - median(v)));
+      std::vector<double> sorted = v;
+      std::sort(sorted.begin(), sorted.end());
+
+      ColumnStats s = columnStats(column);
+      assert(s.count == n);
+      assert(close(s.mean, mean));
+      assert(close(s.variance, n > 1 ? ss / (n - 1) : 0.0));
+      assert(s.min == sorted.front() && s.max == sorted.back());
+      assert(s.median == median(v) && s.mad == median(dev));
+      assert(s.q1 == sorted[n / 4] && s.q3 == sorted[3 * n / 4]);
+    }
+    assert(columnStats(NumericColumn({{"v"}, {"x"}}, 0)).count == 0);
+    std::cout << "PASS: column statistics match a scalar reference\n";
+  }
+
+  void test_interpolated_quantile() {
+    Table t = {{"v"}, {"4"}, {"1"}, {"3"}, {"2"}};
+    NumericColumn column(t, 0);
+    // numpy.quantile([1, 2, 3, 4], q)
+    assert(close(columnQuantile(column, 0.25), 1.75));
+    assert(close(columnQuantile(column, 0.5), 2.5));
+    assert(columnQuantile(column, 0.0) == 1.0 && columnQuantile(column, 1.0) == 4.0);
+    std::cout << "PASS: quantiles interpolate like numpy\n";
+  }
+
+  void test_requested_fields_with_shared_scratch() {
+    // one column and one buffer reused across columns of different sizes
+    NumericColumn column;
+    std::vector<double> scratch;
+    for (size_t n : {1003u, 4u, 9u, 250u}) {
+      Table t = table(n, static_cast<unsigned>(n) * 7);
+      column.assign(t, 1);
+      assert(column.count() == n && column.rows() == t.size());
+      ColumnStats all = columnStats(column, scratch);
+      ColumnStats quart = columnStats(column, scratch, STATS_QUARTILES);
+      assert(quart.q1 == all.q1 && quart.q3 == all.q3 && quart.median == 0.0);
+      ColumnStats mad = columnStats(column, scratch, STATS_MAD);
+      assert(mad.median == all.median && mad.mad == all.mad && mad.mean == 0.0);
+      ColumnStats moments = columnStats(column, scratch, STATS_MOMENTS);
+      assert(moments.mean == all.mean && moments.stddev == all.stddev && moments.q3 == 0.0);
+      for (double tail : {0.0, 0.01, 0.25, 0.5}) {
+        double lo, hi;
+        columnQuantiles(column, scratch, tail, 1.0 - tail, lo, hi);
+        assert(lo == columnQuantile(column, tail) && hi == columnQuantile(column, 1.0 - tail));
+      }
+    }
+    std::cout << "PASS: requested fields and paired quantiles from a shared buffer\n";
+  }
+
+  void test_outlier_methods() {
+    Table t = {{"v"}};
+    for (int i = 0; i < 200; i++) t.push_back({std::to_string(10 + i % 11)});
+    t.push_back({"95"});
+    t.push_back({"-60"});
+    const size_t high = t.size() - 2, low = t.size() - 1;
+
+    OutlierMethod m;
+    assert(parseOutlierMethod("modified-zscore", m) && m == OutlierMethod::MODIFIED_ZSCORE);
+    assert(!parseOutlierMethod("zscores", m));
+
+    for (OutlierMethod method : {OutlierMethod::IQR, OutlierMethod::ZSCORE, OutlierMethod::MODIFIED_ZSCORE}) {
+      OutlierOptions options;
+      options.method = method;
+      auto rows = detectOutliers(t, options);
+      assert(rows == std::vector<int>({static_cast<int>(high), static_cast<int>(low)}));
+    }
+
+    // a 1% tail on each side: the two extremes plus the 10s and 20s beyond
+    // the interpolated 1st / 99th percentiles
+    OutlierOptions clip;
+    clip.method = OutlierMethod::PERCENTILE;
+    auto flagged = detectOutlierRows(t, clip);
+    assert(flagged.test(high) && flagged.test(low) && !flagged.test(0));
+    NumericColumn column(t, 0);
+    double lo = columnQuantile(column, 0.01), hi = columnQuantile(column, 0.99);
+    size_t expected = 0;
+    for (size_t r = 1; r < t.size(); r++)
+      if (column.value(r) < lo || column.value(r) > hi) expected++;
+    assert(flagged.count() == expected);
+
+    // a wide threshold flags nothing; constant columns never flag
+    OutlierOptions wide;
+    wide.method = OutlierMethod::ZSCORE;
+    wide.threshold = 50;
+    assert(detectOutlierRows(t, wide).count() == 0);
+    Table flat = {{"v"}, {"5"}, {"5"}, {"5"}, {"5"}, {"5"}};
+    for (OutlierMethod method : {OutlierMethod::ZSCORE, OutlierMethod::MODIFIED_ZSCORE}) {
+      OutlierOptions options;
+      options.method = method;
+      assert(detectOutlierRows(flat, options).count() == 0);
+    }
+    std::cout << "PASS: z-score, modified z-score and percentile methods\n";
+  }
+
+  void run_all() {
+    test_stats_match_scalar_reference();
+    test_interpolated_quantile();
+    test_requested_fields_with_shared_scratch();
+    test_outlier_methods();
+    std::cout << "\nAll numeric column tests passed (4/4)\n";
+  }
+};
+
+int main() {
+  NumericColumnTest tests;
+  tests.run_all();
+  return 0;
+}
@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "string_issue_detectors.h"
+#include "structural_cleaners.h"
+
+using Table = std::vector<std::vector<std::string>>;
+
+class OutlierDetectionTest {
+public:
+  // the previous implementation: stod, a full sort per column, a std::set
+  std::vector<int> reference(const Table& data) {
+    std::set<int> out;
+    for (size_t col = 0; col < data[0].size(); col++) {
+      std::vector<double> values;
+      std::vector<int> rows;
+      for (size_t r = 1; r < data.size(); r++) {
+        double v;
+        if (col < data[r].size() && parseNumericCell(data[r][col], v)) {
+          values.push_back(std::stod(data[r][col]));
+          rows.push_back(static_cast<int>(r));
+        }
+      }
+      if (values.size() < 4) continue;
+      std::vector<double> sorted = values;
+      std::sort(sorted.begin(), sorted.end());
+      size_t n = sorted.size();
+      double q1 = sorted[n / 4], q3 = sorted[3 * n / 4], iqr = q3 - q1;
+      for (size_t i = 0; i < values.size(); i++)
+        if (values[i] < q1 - 1.5 * iqr || values[i] > q3 + 1.5 * iqr) out.insert(rows[i]);
+    }
+    return std::vector<int>(out.begin(), out.end());
+  }
+
+  Table makeTable(int rows, unsigned seed) {
+    Table t = {{"a", "b", "label", "c"}};
+    for (int i = 0; i < rows; i++) {
+      seed = seed * 1103515245u + 12345u;
+      unsigned r = seed >> 8;
+      std::string a = std::to_string(static_cast<int>(r % 200) - 100) + "." + std::to_string(r % 10);
+      if (r % 97 == 0) a = "+" + std::to_string(r % 100000);
+      std::string b = r % 13 == 0 ? "" : std::to_string((r >> 4) % 50);
+      std::string c = r % 89 == 0 ? "-" + std::to_string(r) : "." + std::to_string(r % 7);
+      t.push_back({a, b, "x" + std::to_string(r % 5), c});
+    }
+    return t;
+  }
+
+  void test_parse_numeric_cell() {
+    double v = 0;
+    assert(parseNumericCell("-12.5", v) && v == -12.5);
+    assert(parseNumericCell("+3", v) && v == 3);
+    assert(parseNumericCell(".5", v) && v == 0.5);
+    assert(parseNumericCell("7.", v) && v == 7);
+    for (const char* bad : {"", "-", "+", ".", "-.", "1.2.3", "1e5", " 1", "abc", "0x10", "--1"})
+      assert(!parseNumericCell(bad, v));
+    std::cout << "PASS: numeric cells parsed with from_chars\n";
+  }
+
+  void test_matches_sort_based_quartiles() {
+    for (unsigned seed : {1u, 7u, 42u}) {
+      for (int rows : {3, 4, 5, 9, 250, 4001}) {
+        Table t = makeTable(rows, seed);
+        assert(detectOutliers(t) == reference(t));
+      }
+    }
+    std::cout << "PASS: selection-based quartiles match the sort-based ones\n";
+  }
+
+  void test_remove_outliers_uses_bitmap() {
+    Table t = makeTable(1000, 3);
+    auto flagged = detectOutlierRows(t);
+    assert(flagged.size() == t.size() && !flagged.test(0));
+    assert(flagged.count() == detectOutliers(t).size() && flagged.count() > 0);
+    auto kept = removeOutliers(t);
+    assert(kept.size() == t.size() - flagged.count());
+    assert(kept[0] == t[0]);
+    // malformed numbers are skipped rather than thrown on
+    Table odd = {{"v"}, {"1"}, {"2"}, {"-."}, {"3"}, {"4"}, {"1000"}};
+    assert(detectOutliers(odd) == std::vector<int>({6}));
+    std::cout << "PASS: removeOutliers drops exactly the flagged rows\n";
+  }
+
+  void run_all() {
+    test_parse_numeric_cell();
+    test_matches_sort_based_quartiles();
+    test_remove_outliers_uses_bitmap();
+    std::cout << "\nAll outlier detection tests passed (3/3)\n";
+  }
+};
+
+int main() {
+  OutlierDetectionTest tests;
+  tests.run_all();
+  return 0;
+}
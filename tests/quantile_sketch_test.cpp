@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "csv_parser.h"
+#include "quantile_sketch.h"
+#include "string_issue_detectors.h"
+
+class QuantileSketchTest {
+public:
+  std::vector<double> values(size_t n, unsigned seed) {
+    std::vector<double> out;
+    for (size_t i = 0; i < n; i++) {
+      seed = seed * 1103515245u + 12345u;
+      out.push_back(static_cast<double>(seed >> 8) / 1000.0);
+    }
+    return out;
+  }
+
+  // |rank of the sketch's answer - target rank| as a fraction of n
+  double rankError(std::vector<double> sorted, double answer, double q) {
+    std::sort(sorted.begin(), sorted.end());
+    double rank = static_cast<double>(std::lower_bound(sorted.begin(), sorted.end(), answer) - sorted.begin());
+    return std::abs(rank - q * sorted.size()) / sorted.size();
+  }
+
+  void test_exact_before_compaction() {
+    auto v = values(150, 3);
+    KllSketch sketch;
+    for (double x : v) sketch.update(x);
+    std::vector<double> sorted = v;
+    std::sort(sorted.begin(), sorted.end());
+    assert(sketch.quantile(0.25) == sorted[150 / 4]);
+    assert(sketch.quantile(0.75) == sorted[3 * 150 / 4]);
+    assert(sketch.retained() == 150);
+    std::cout << "PASS: small inputs give exact quantiles\n";
+  }
+
+  void test_rank_error_and_merge() {
+    auto v = values(200000, 9);
+    KllSketch whole;
+    std::vector<KllSketch> parts;
+    for (int p = 0; p < 4; p++) parts.emplace_back(200, 100 + p);
+    for (size_t i = 0; i < v.size(); i++) {
+      whole.update(v[i]);
+      parts[i % 4].update(v[i]);
+    }
+    for (int p = 1; p < 4; p++) parts[0].merge(parts[p]);
+    assert(parts[0].count() == v.size());
+    assert(whole.retained() < 2000);
+    for (double q : {0.01, 0.25, 0.5, 0.75, 0.99}) {
+      assert(rankError(v, whole.quantile(q), q) < 0.02);
+      assert(rankError(v, parts[0].quantile(q), q) < 0.02);
+    }
+    std::cout << "PASS: bounded rank error, merged sketches included\n";
+  }
+
+  std::string makeCsv(size_t rows, bool quoted) {
+    std::string csv = "id,score,label,amount\n";
+    unsigned seed = 5;
+    for (size_t i = 0; i < rows; i++) {
+      seed = seed * 1103515245u + 12345u;
+      unsigned r = seed >> 8;
+      std::string score = i % 1000 == 7 ? "10000" : std::to_string(r % 100);
+      std::string amount = i % 1500 == 11 ? "-5000.5" : std::to_string(r % 40) + ".25";
+      std::string label = quoted && i % 10 == 0 ? "\"multi\nline\"" : "x" + std::to_string(r % 3);
+      csv += std::to_string(i) + "," + score + "," + label + "," + amount + "\n";
+    }
+    return csv;
+  }
+
+  void test_streaming_matches_in_memory() {
+    // small: exact sketches, so identical to the in-memory detector
+    std::string small = makeCsv(180, true);
+    auto expected = detectOutlierRows(parseCSV(small));
+    auto got = detectOutliersStreaming(small, 4);
+    assert(got.size() == expected.size() && got.words() == expected.words());
+
+    // large, unquoted: split across threads; the planted outliers are far
+    // outside the fences, so the approximate quartiles flag the same rows
+    for (bool quoted : {false, true}) {
+      std::string big = makeCsv(400000, quoted);
+      auto exact = detectOutlierRows(parseCSV(big));
+      auto streamed = detectOutliersStreaming(big, 4);
+      assert(streamed.size() == exact.size());
+      assert(streamed.words() == exact.words());
+      assert(streamed.count() == 400 + 267);
+    }
+    std::cout << "PASS: streaming two-pass detection matches in-memory detection\n";
+  }
+
+  void run_all() {
+    test_exact_before_compaction();
+    test_rank_error_and_merge();
+    test_streaming_matches_in_memory();
+    std::cout << "\nAll quantile sketch tests passed (3/3)\n";
+  }
+};
+
+int main() {
+  QuantileSketchTest tests;
+  tests.run_all();
+  return 0;
+}
@@ -0,0 +1,96 @@
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "reference_dictionary.h"
+
+class ReferenceDictionaryTest {
+public:
+  const std::string countries =
+      "name,alpha2,alpha3,other\n"
+      "United Kingdom,GB,GBR,Great Britain,UK\n"
+      "United States,US,USA,United States of America\n"
+      "Germany,DE,DEU,Deutschland\n"
+      "France,FR,FRA,\n"
+      "C\xC3\xB4te d'Ivoire,CI,CIV,Ivory Coast\n"
+      "Austria,AT,AUT,\n"
+      "Australia,AU,AUS,\n";
+
+  std::string canonicalOf(const ReferenceDictionary& d, const std::string& cell, int maxEdits = -1) {
+    auto m = d.lookup(cell, maxEdits);
+    return m.kind == ReferenceMatchKind::NONE ? "" : d.canonical(m.canonical);
+  }
+
+  void test_exact_and_folded() {
+    auto d = sharedReferenceDictionary(countries);
+    assert(d->size() == 7);
+    assert(d->lookup("USA").kind == ReferenceMatchKind::EXACT);
+    assert(canonicalOf(*d, "U.S.A.") == "United States");
+    assert(canonicalOf(*d, "  great   BRITAIN ") == "United Kingdom");
+    assert(canonicalOf(*d, "cote divoire") == "C\xC3\xB4te d'Ivoire");
+    std::cout << "PASS: exact lookups on folded keys\n";
+  }
+
+  void test_unique_prefix() {
+    auto d = sharedReferenceDictionary(countries);
+    auto m = d->lookup("Deutsch");
+    assert(m.kind == ReferenceMatchKind::PREFIX && d->canonical(m.canonical) == "Germany");
+    // "austr" starts both Austria and Australia
+    assert(d->lookup("Austr", 0).kind == ReferenceMatchKind::NONE);
+    // below the minimum prefix length
+    assert(d->lookup("Ge", 0).kind == ReferenceMatchKind::NONE);
+    std::cout << "PASS: prefix lookups only when one canonical value completes them\n";
+  }
+
+  void test_edit_distance() {
+    auto d = sharedReferenceDictionary(countries);
+    auto m = d->lookup("Germnay", 2);
+    assert(m.kind == ReferenceMatchKind::FUZZY && m.distance == 2);
+    assert(d->canonical(m.canonical) == "Germany");
+    assert(canonicalOf(*d, "Frence") == "France");
+    assert(canonicalOf(*d, "Frence", 0).empty());
+    assert(canonicalOf(*d, "Untied Kingdom") == "United Kingdom");
+    // one edit from Australia, more from Austria
+    assert(canonicalOf(*d, "Australa") == "Australia");
+    // one edit from both: ambiguous
+    assert(canonicalOf(*d, "Austrlia").empty());
+    assert(canonicalOf(*d, "Narnia").empty());
+    std::cout << "PASS: edit-distance lookups pick the closest canonical value\n";
+  }
+
+  void test_shared_and_column_standardised() {
+    auto a = sharedReferenceDictionary(countries);
+    auto b = sharedReferenceDictionary(countries);
+    assert(a.get() == b.get());
+
+    std::vector<std::vector<std::string>> data = {
+        {"id", "country"}, {"1", "UK"}, {"2", "germny"}, {"3", "Germany"},
+        {"4", ""},         {"5", "Narnia"}, {"6", "uk"}};
+    auto r = standardiseToReference(data, "country", *a);
+    assert(r.data[1][1] == "United Kingdom" && r.data[6][1] == "United Kingdom");
+    assert(r.data[2][1] == "Germany" && r.data[5][1] == "Narnia" && r.data[4][1].empty());
+    assert(r.exactMatches == 3 && r.fuzzyMatches == 1 && r.unmatched == 1);
+    assert(r.cellsChanged == 3);
+    bool threw = false;
+    try { standardiseToReference(data, "missing", *a); }
+    catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+    std::cout << "PASS: shared dictionary standardises a column\n";
+  }
+
+  void run_all() {
+    test_exact_and_folded();
+    test_unique_prefix();
+    test_edit_distance();
+    test_shared_and_column_standardised();
+    std::cout << "\nAll reference dictionary tests passed (4/4)\n";
+  }
+};
+
+int main() {
+  ReferenceDictionaryTest tests;
+  tests.run_all();
+  return 0;
+}
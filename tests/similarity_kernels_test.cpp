@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "similarity_kernels.h"
+
+class SimilarityKernelsTest {
+public:
+  bool near(double a, double b, double eps = 1e-3) { return std::fabs(a - b) < eps; }
+
+  // textbook Jaro-Winkler, one byte at a time
+  double referenceJaroWinkler(const std::string& a, const std::string& b) {
+    if (a == b) return 1.0;
+    if (a.empty() || b.empty()) return 0.0;
+    size_t window = std::max(a.size(), b.size()) / 2;
+    window = window > 0 ? window - 1 : 0;
+    std::vector<bool> am(a.size()), bm(b.size());
+    double m = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+      size_t lo = i > window ? i - window : 0, hi = std::min(i + window + 1, b.size());
+      for (size_t j = lo; j < hi; j++) {
+        if (!bm[j] && a[i] == b[j]) { am[i] = bm[j] = true; m++; break; }
+      }
+    }
+    if (m == 0) return 0.0;
+    double t = 0;
+    for (size_t i = 0, j = 0; i < a.size(); i++) {
+      if (!am[i]) continue;
+      while (!bm[j]) j++;
+      if (a[i] != b[j]) t++;
+      j++;
+    }
+    double jaro = (m / a.size() + m / b.size() + (m - t / 2) / m) / 3;
+    if (jaro <= 0.7) return jaro;
+    size_t p = 0;
+    while (p < 4 && p < a.size() && p < b.size() && a[p] == b[p]) p++;
+    return jaro + p * 0.1 * (1 - jaro);
+  }
+
+  std::string randomText(unsigned& seed, size_t len, int alphabet) {
+    std::string s;
+    for (size_t k = 0; k < len; k++) {
+      seed = seed * 1103515245u + 12345u;
+      s += static_cast<char>('a' + (seed >> 16) % alphabet);
+    }
+    return s;
+  }
+
+  void test_jaro_winkler_known_values() {
+    assert(near(jaroWinkler("martha", "marhta"), 0.9611));
+    assert(near(jaroWinkler("dwayne", "duane"), 0.84));
+    assert(near(jaroWinkler("dixon", "dicksonx"), 0.8133));
+    assert(jaroWinkler("abc", "abc") == 1.0);
+    assert(jaroWinkler("", "abc") == 0.0);
+    assert(jaroWinkler("abc", "xyz") == 0.0);
+    std::cout << "PASS: Jaro-Winkler known values\n";
+  }
+
+  void test_jaro_winkler_matches_reference_on_long_inputs() {
+    // lengths past 16 exercise the vector window scan, past 256 the heap path
+    unsigned seed = 99;
+    for (int k = 0; k < 300; k++) {
+      std::string a = randomText(seed, 1 + k % 310, 4);
+      std::string b = randomText(seed, 1 + (k * 7) % 290, 4);
+      assert(near(jaroWinkler(a, b), referenceJaroWinkler(a, b), 1e-12));
+    }
+    std::cout << "PASS: Jaro-Winkler matches scalar reference\n";
+  }
+
+  void test_levenshtein_ratio() {
+    assert(near(levenshteinRatio("kitten", "sitting"), 1.0 - 3.0 / 7.0, 1e-12));
+    assert(levenshteinRatio("", "") == 1.0);
+    assert(levenshteinRatio("abc", "") == 0.0);
+    std::string longA(400, 'a'), longB = longA;
+    longB[200] = 'b';
+    assert(near(levenshteinRatio(longA, longB), 1.0 - 1.0 / 400, 1e-12));
+    std::cout << "PASS: Levenshtein ratio\n";
+  }
+
+  void test_token_ratios() {
+    assert(sortedTokens("Smith,  JOHN") == "john smith");
+    assert(tokenSortRatio(sortedTokens("John Smith"), sortedTokens("smith john")) == 1.0);
+    std::string a = sortedTokens("John Smith"), b = sortedTokens("John A. Smith");
+    assert(tokenSetRatio(a, b) == 1.0);       // a's tokens are a subset of b's
+    assert(tokenSortRatio(a, b) < 1.0);
+    assert(tokenSetRatio(sortedTokens("alpha beta"), sortedTokens("gamma delta")) < 0.5);
+    assert(tokenSetRatio("", "x") == 0.0);
+    std::cout << "PASS: token sort and token set ratios\n";
+  }
+
+  void test_qgram_jaccard() {
+    std::string text = "The quick brown fox jumps over the lazy dog near the river bank";
+    auto sig = qgramSignature(text);
+    assert(qgramJaccard(sig, qgramSignature("the QUICK  brown fox jumps over the lazy dog near the river bank ")) == 1.0);
+    double edited = qgramJaccard(sig, qgramSignature("The quick brown fox jumped over the lazy dog near the river bank"));
+    assert(edited > 0.8 && edited < 1.0);
+    assert(qgramJaccard(sig, qgramSignature("Completely unrelated sentence about tax forms")) < 0.2);
+    assert(qgramJaccard(qgramSignature("ab"), qgramSignature("ab")) == 1.0);
+    assert(qgramJaccard(qgramSignature("ab"), qgramSignature("xy")) == 0.0);
+    std::cout << "PASS: q-gram Jaccard signatures\n";
+  }
+
+  void run_all() {
+    test_jaro_winkler_known_values();
+    test_jaro_winkler_matches_reference_on_long_inputs();
+    test_levenshtein_ratio();
+    test_token_ratios();
+    test_qgram_jaccard();
+    std::cout << "\nAll similarity kernel tests passed (5/5)\n";
+  }
+};
+
+int main() {
+  SimilarityKernelsTest tests;
+  tests.run_all();
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ascii_kernels.h"
+#include "similarity_kernels.h"
+#include "string_issue_detectors.h"
+#include "text_normalisation.h"
+#include "utf8.h"
+
+class Utf8Test {
+public:
+  bool near(double a, double b) { return std::fabs(a - b) < 1e-12; }
+
+  void test_decode_and_round_trip() {
+    std::vector<char32_t> cps;
+    decodeUtf8("a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80", cps);  // a é € 😀
+    assert((cps == std::vector<char32_t>{U'a', 0xE9, 0x20AC, 0x1F600}));
+    assert(codePointCount("na\xC3\xAFve") == 5);
+    assert(codePointCount("plain") == 5);
+
+    // stray continuation, truncated sequence, overlong '/', encoded surrogate
+    const std::string bad = "\x80x\xE2\x82 \xC0\xAF\xED\xA0\x80\xFF";
+    decodeUtf8(bad, cps);
+    assert(cps.size() == bad.size());  // one code point per byte
+    assert(cps[0] == 0xDC80 && cps[1] == U'x');
+    std::string back;
+    for (char32_t cp : cps) appendUtf8(cp, back);
+    assert(back == bad);
+    assert(toUpperCase(bad) == "\x80X\xE2\x82 \xC0\xAF\xED\xA0\x80\xFF");
+    std::cout << "PASS: decoding, and invalid bytes round-trip unchanged\n";
+  }
+
+  void test_case_mapping() {
+    assert(toUpperCase("caf\xC3\xA9") == "CAF\xC3\x89");                 // é -> É
+    assert(toLowerCase("\xC3\x89LODIE") == "\xC3\xA9lodie");
+    assert(toUpperCase("\xD0\xBC\xD0\xB8\xD1\x80") == "\xD0\x9C\xD0\x98\xD0\xA0");  // мир -> МИР
+    assert(toUpperCase("stra\xC3\x9F""e") == "STRA\xC3\x9F""E");        // ß has no one-letter upper case
+    assert(toUpperCase("\xC3\xBF") == "\xC5\xB8");                      // ÿ -> Ÿ, 0xFF -> 0x178
+    assert(toLowerCase("\xF0\x90\x90\x80") == "\xF0\x90\x90\xA8");      // Deseret, 4 bytes
+    assert(toUpperCase("\xC4\xB1") == "I");                             // dotless ı shrinks to 1 byte
+    std::string cell = "\xC3\xA9t\xC3\xA9";
+    toUpperCaseInPlace(cell);
+    assert(cell == "\xC3\x89T\xC3\x89");
+
+    // folding makes final and medial sigma compare equal; lower-casing does not
+    assert(utf8FoldCase("\xCE\xA3\xCF\x82") == "\xCF\x83\xCF\x83");
+    assert(utf8ToLower("\xCE\xA3\xCF\x82") == "\xCF\x83\xCF\x82");
+    assert(upperCodePoint(U'q') == U'Q' && foldCodePoint(U'Q') == U'q');
+    std::cout << "PASS: case mapping through the Unicode tables\n";
+  }
+
+  void test_code_point_edit_distance() {
+    assert(levenshteinDistance("kitten", "sitting") == 3);
+    assert(levenshteinDistance("caf\xC3\xA9", "cafe") == 1);
+    assert(levenshteinDistance("M\xC3\xBCller", "Mueller") == 2);
+    assert(levenshteinDistance("\xE6\x9D\xB1\xE4\xBA\xAC", "\xE4\xBA\xAC\xE9\x83\xBD") == 2);  // 東京 / 京都
+    assert(near(calculateSimilarity("Jos\xC3\xA9", "JOS\xC3\x89"), 1.0));
+    assert(near(calculateSimilarity("Jos\xC3\xA9", "Jose"), 0.75));
+    assert(near(levenshteinRatio("caf\xC3\xA9", "cafe"), 0.75));
+    assert(near(levenshteinRatio("kitten", "sitting"), 1.0 - 3.0 / 7.0));
+    assert(sortedTokens("\xC3\x89mile Zola") == sortedTokens("zola \xC3\xA9mile"));
+    std::cout << "PASS: edit distance counts code points, not bytes\n";
+  }
+
+  void test_ascii_check() {
+    std::string text(300, 'a');
+    assert(isAscii(text.data(), text.size()));
+    for (size_t pos : {0, 15, 16, 63, 64, 131, 299}) {
+      std::string t = text;
+      t[pos] = '\xC3';
+      assert(!isAscii(t.data(), t.size()));
+      assert(isAscii(t.data(), pos));
+    }
+    assert(isAscii("", 0));
+    std::cout << "PASS: ASCII check at every block position\n";
+  }
+
+  void run_all() {
+    test_decode_and_round_trip();
+    test_case_mapping();
+    test_code_point_edit_distance();
+    test_ascii_check();
+    std::cout << "\nAll UTF-8 tests passed (4/4)\n";
+  }
+};
+
+int main() {
+  Utf8Test tests;
+  tests.run_all();
+  return 0;
+}